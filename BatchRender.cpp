@@ -0,0 +1,415 @@
+#include "BatchRender.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "EdgeStrips.h"
+#include "EulerScript.h"
+#include "Tessellation.h"
+#include "ThreadPool.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+void putU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+void putU32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+// 一个模型的三角网格、串成折线的边和让模型充满画面的视图参数（旋转角度每张图像另设）
+struct LoadedModel {
+    TriangleMesh mesh;
+    EdgeStrips strips;    // 顶点下标与 mesh.positions 一致，线框模式使用
+    ViewParams view = {};
+    std::string name;     // 输出文件名的前缀
+    bool ok = false;
+    std::string error;
+};
+
+void loadModel(const std::string& path, int width, int height, bool wireframe, LoadedModel& model) {
+    EulerScript script;
+    if (!readEulerScript(path, script, &model.error)) return;
+    size_t failed = 0;
+    std::unique_ptr<Body> body(replayEulerScript(script, &failed));
+    if (!body) {
+        model.error = "无法重放脚本";
+        return;
+    }
+    if (failed) model.error = std::to_string(failed) + " 个操作执行失败";
+    tessellateBody(body.get(), model.mesh);
+    if (wireframe) buildEdgeStrips(body.get(), model.strips);
+
+    // 包围盒中心作为模型中心，包围球投影后占画面短边的九成
+    const std::vector<Point3D>& p = model.mesh.positions;
+    if (p.empty()) {
+        model.error = "模型没有顶点";
+        return;
+    }
+    Point3D lo = p[0], hi = p[0];
+    for (const Point3D& q : p) {
+        lo = Point3D{std::min(lo.x, q.x), std::min(lo.y, q.y), std::min(lo.z, q.z)};
+        hi = Point3D{std::max(hi.x, q.x), std::max(hi.y, q.y), std::max(hi.z, q.z)};
+    }
+    model.view.center = Point3D{(lo.x + hi.x) / 2, (lo.y + hi.y) / 2, (lo.z + hi.z) / 2};
+    float radius = 0.5f * std::sqrt((hi.x - lo.x) * (hi.x - lo.x) + (hi.y - lo.y) * (hi.y - lo.y) +
+                                    (hi.z - lo.z) * (hi.z - lo.z));
+    model.view.scale = radius > 0 ? 0.45f * std::min(width, height) / (100.0f * radius) : 1.0f;
+    model.ok = true;
+}
+
+// 渲染结果，像素按行紧密排列
+struct Frame {
+    std::vector<uint32_t> pixels;
+    size_t image = 0;
+};
+
+// 渲染任务与写出线程之间的队列：空闲帧缓冲的个数限制了排队等待写出的帧数
+class FrameQueue
+{
+public:
+    FrameQueue(size_t _frames, size_t _pixels) : frames_(_frames)
+    {
+        for (Frame& frame : frames_)
+        {
+            frame.pixels.resize(_pixels);
+            free_.push_back(&frame);
+        }
+    }
+
+    // 取一个空闲帧缓冲，没有时等待写出线程归还
+    Frame* acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        free_cv_.wait(lock, [this] { return !free_.empty(); });
+        Frame* frame = free_.back();
+        free_.pop_back();
+        return frame;
+    }
+    void release(Frame* _frame)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(_frame);
+        }
+        free_cv_.notify_one();
+    }
+
+    void push(Frame* _frame)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(_frame);
+        }
+        ready_cv_.notify_one();
+    }
+    // 取下一个待写出的帧；close 之后队列为空时返回空
+    Frame* pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_cv_.wait(lock, [this] { return !ready_.empty() || closed_; });
+        if (ready_.empty()) return nullptr;
+        Frame* frame = ready_.front();
+        ready_.pop_front();
+        return frame;
+    }
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        ready_cv_.notify_all();
+    }
+
+private:
+    std::vector<Frame> frames_;
+    std::vector<Frame*> free_;
+    std::deque<Frame*> ready_;
+    std::mutex mutex_;
+    std::condition_variable free_cv_;
+    std::condition_variable ready_cv_;
+    bool closed_ = false;
+};
+
+// 各渲染线程使用的单线程光栅化器；任一时刻运行的任务数不超过线程数，因此不会取空
+class RasterizerSet
+{
+public:
+    RasterizerSet(unsigned _count, int _width, int _height)
+    {
+        for (unsigned i = 0; i < _count; i++)
+        {
+            std::unique_ptr<SoftwareRasterizer> rasterizer(new SoftwareRasterizer(1));
+            rasterizer->resize(_width, _height);
+            free_.push_back(rasterizer.get());
+            all_.push_back(std::move(rasterizer));
+        }
+    }
+
+    SoftwareRasterizer* acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        SoftwareRasterizer* rasterizer = free_.back();
+        free_.pop_back();
+        return rasterizer;
+    }
+    void release(SoftwareRasterizer* _rasterizer)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(_rasterizer);
+    }
+
+private:
+    std::vector<std::unique_ptr<SoftwareRasterizer>> all_;
+    std::vector<SoftwareRasterizer*> free_;
+    std::mutex mutex_;
+};
+
+// 升序排列后的第 q 分位数
+double percentile(std::vector<double> values, double q) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t i = (size_t)std::min<double>((double)values.size() - 1, std::floor(q * (values.size() - 1) + 0.5));
+    return values[i];
+}
+
+} // namespace
+
+bool parseBatchArguments(const std::vector<std::string>& args, BatchOptions& options, std::string* error) {
+    auto number = [&](size_t& i, int& value) {
+        if (i + 1 >= args.size()) return false;
+        value = std::atoi(args[++i].c_str());
+        return value > 0;
+    };
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        int value = 0;
+        if (arg == "--out") {
+            if (i + 1 >= args.size()) return fail(error, "--out 缺少目录");
+            options.outputDir = args[++i];
+        } else if (arg == "--angles") {
+            if (!number(i, options.angles)) return fail(error, "--angles 需要正整数");
+        } else if (arg == "--size") {
+            if (i + 1 >= args.size() || std::sscanf(args[++i].c_str(), "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                return fail(error, "--size 的格式为 宽x高");
+            }
+        } else if (arg == "--threads") {
+            if (!number(i, value)) return fail(error, "--threads 需要正整数");
+            options.threads = (unsigned)value;
+        } else if (arg == "--frames") {
+            if (!number(i, value)) return fail(error, "--frames 需要正整数");
+            options.frames = (size_t)value;
+        } else if (arg == "--flat") {
+            options.shade = SHADE_FLAT;
+        } else if (arg == "--wire") {
+            options.wireframe = true;
+        } else if (arg.size() > 1 && arg[0] == '-' && arg[1] == '-') {
+            return fail(error, "未知参数 " + arg);
+        } else {
+            options.models.push_back(arg);
+        }
+    }
+    return !options.models.empty() || fail(error, "没有给出模型");
+}
+
+bool writeBmp(const std::string& path, const uint32_t* pixels, int width, int height, int stride,
+              std::string* error) {
+    if (width <= 0 || height <= 0 || stride < width) return fail(error, "图像尺寸不合法");
+    const uint32_t HEADER = 14 + 40;
+    uint32_t imageBytes = (uint32_t)width * (uint32_t)height * 4;
+    uint8_t header[HEADER] = {};
+    header[0] = 'B';
+    header[1] = 'M';
+    putU32(header + 2, HEADER + imageBytes);
+    putU32(header + 10, HEADER);
+    putU32(header + 14, 40);
+    putU32(header + 18, (uint32_t)width);
+    putU32(header + 22, (uint32_t)-height);   // 高度为负：自顶向下，与颜色缓冲的行顺序一致
+    putU16(header + 26, 1);
+    putU16(header + 28, 32);
+    putU32(header + 34, imageBytes);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return fail(error, "无法创建文件 " + path);
+    bool ok = std::fwrite(header, 1, HEADER, file) == HEADER;
+    if (stride == width) {
+        ok = ok && std::fwrite(pixels, 4, (size_t)width * height, file) == (size_t)width * height;
+    } else {
+        for (int y = 0; y < height && ok; y++) {
+            ok = std::fwrite(pixels + (size_t)y * stride, 4, (size_t)width, file) == (size_t)width;
+        }
+    }
+    ok = std::fclose(file) == 0 && ok;
+    return ok ? true : fail(error, "写入失败 " + path);
+}
+
+bool runBatchRender(const BatchOptions& options, BatchReport& report, std::string* error) {
+    report = BatchReport();
+    if (options.models.empty()) return fail(error, "没有给出模型");
+    if (options.angles <= 0) return fail(error, "角度数必须为正");
+    if (options.width <= 0 || options.height <= 0) return fail(error, "图像尺寸必须为正");
+    std::error_code ec;
+    std::filesystem::create_directories(options.outputDir, ec);
+    if (ec) return fail(error, "无法创建输出目录 " + options.outputDir + ": " + ec.message());
+
+    ThreadPool pool(options.threads);
+    report.threads = pool.size();
+
+    // 第一步：并行读取并三角化各模型；每个任务内部串行三角化，避免在任务中等待同一线程池
+    Clock::time_point start = Clock::now();
+    std::vector<LoadedModel> models(options.models.size());
+    for (size_t m = 0; m < models.size(); m++) {
+        pool.submit([&options, &models, m] {
+            loadModel(options.models[m], options.width, options.height, options.wireframe, models[m]);
+        });
+    }
+    pool.wait();
+    report.loadMs = millisecondsSince(start);
+
+    // 输出文件名取模型文件名（不含扩展名），重名时附加模型序号
+    std::unordered_map<std::string, int> used;
+    for (size_t m = 0; m < models.size(); m++) {
+        LoadedModel& model = models[m];
+        model.name = std::filesystem::path(options.models[m]).stem().string();
+        if (used[model.name]++ > 0) model.name += "_" + std::to_string(m);
+        if (!model.ok) {
+            report.errors.push_back(options.models[m] + ": " + model.error);
+            continue;
+        }
+        if (!model.error.empty()) report.errors.push_back(options.models[m] + ": " + model.error);
+        report.modelsLoaded++;
+        report.triangles += model.mesh.triangleCount();
+        for (int k = 0; k < options.angles; k++) {
+            BatchImage image;
+            char suffix[16];
+            std::snprintf(suffix, sizeof(suffix), "_%03d.bmp", k);
+            image.path = (std::filesystem::path(options.outputDir) / (model.name + suffix)).string();
+            image.model = m;
+            image.angle = k;
+            report.images.push_back(image);
+        }
+    }
+
+    // 第二步：每张图像一个任务，写出线程与渲染并行
+    size_t frameCount = options.frames > 0 ? options.frames : (size_t)pool.size() * 2;
+    FrameQueue queue(frameCount, (size_t)options.width * options.height);
+    RasterizerSet rasterizers(pool.size(), options.width, options.height);
+    std::vector<std::string> writeErrors;
+
+    start = Clock::now();
+    std::thread writer([&] {
+        while (Frame* frame = queue.pop()) {
+            BatchImage& image = report.images[frame->image];
+            Clock::time_point begin = Clock::now();
+            std::string message;
+            image.written = writeBmp(image.path, frame->pixels.data(), options.width, options.height,
+                                     options.width, &message);
+            image.writeMs = millisecondsSince(begin);
+            if (image.written) {
+                report.bytesWritten += 54 + frame->pixels.size() * 4;
+            } else {
+                writeErrors.push_back(message);
+            }
+            queue.release(frame);
+        }
+    });
+
+    const float TWO_PI = 6.28318530717958f;
+    for (size_t i = 0; i < report.images.size(); i++) {
+        pool.submit([&, i] {
+            BatchImage& image = report.images[i];
+            const LoadedModel& model = models[image.model];
+            Clock::time_point begin = Clock::now();
+            Frame* frame = queue.acquire();
+            image.waitMs = millisecondsSince(begin);
+
+            begin = Clock::now();
+            ViewParams view = model.view;
+            view.rotationX = options.elevation;
+            view.rotationY = TWO_PI * image.angle / options.angles;
+            SoftwareRasterizer* rasterizer = rasterizers.acquire();
+            if (options.wireframe) {
+                rasterizer->render_line_strips(model.mesh.positions, model.strips, view);
+            } else {
+                rasterizer->render(model.mesh, view, options.shade);
+            }
+            const uint32_t* src = rasterizer->pixels();
+            for (int y = 0; y < options.height; y++) {
+                std::copy(src + (size_t)y * rasterizer->stride(), src + (size_t)y * rasterizer->stride() + options.width,
+                          frame->pixels.begin() + (size_t)y * options.width);
+            }
+            rasterizers.release(rasterizer);
+            image.renderMs = millisecondsSince(begin);
+
+            frame->image = i;
+            queue.push(frame);
+        });
+    }
+    pool.wait();
+    queue.close();
+    writer.join();
+    report.renderWallMs = millisecondsSince(start);
+    report.errors.insert(report.errors.end(), writeErrors.begin(), writeErrors.end());
+    return true;
+}
+
+void printBatchReport(std::ostream& out, const BatchReport& report) {
+    char line[512];
+    std::vector<double> render, write;
+    double wait = 0;
+    for (const BatchImage& image : report.images) {
+        std::snprintf(line, sizeof(line), "  %-40s 渲染 %8.3f ms  写出 %8.3f ms  等待 %8.3f ms%s\n",
+                      image.path.c_str(), image.renderMs, image.writeMs, image.waitMs, image.written ? "" : "  失败");
+        out << line;
+        render.push_back(image.renderMs);
+        write.push_back(image.writeMs);
+        wait += image.waitMs;
+    }
+    for (const std::string& message : report.errors) {
+        out << "  错误: " << message << "\n";
+    }
+
+    size_t written = report.imagesWritten();
+    double seconds = report.renderWallMs / 1000.0;
+    std::snprintf(line, sizeof(line),
+                  "批量渲染: %zu 个模型（%zu 个三角形），%zu 张图像，%u 个线程\n"
+                  "  读取与三角化 %.1f ms，渲染与写出 %.1f ms\n"
+                  "  吞吐量 %.1f 张/秒，%.1f MB/秒\n",
+                  report.modelsLoaded, report.triangles, written, report.threads,
+                  report.loadMs, report.renderWallMs,
+                  seconds > 0 ? written / seconds : 0.0,
+                  seconds > 0 ? report.bytesWritten / (1024.0 * 1024.0) / seconds : 0.0);
+    out << line;
+    if (!render.empty()) {
+        std::snprintf(line, sizeof(line),
+                      "  每张渲染 中位数 %.3f ms  p95 %.3f ms  最大 %.3f ms\n"
+                      "  每张写出 中位数 %.3f ms  p95 %.3f ms  最大 %.3f ms\n"
+                      "  等待帧缓冲共 %.1f ms\n",
+                      percentile(render, 0.5), percentile(render, 0.95), percentile(render, 1.0),
+                      percentile(write, 0.5), percentile(write, 0.95), percentile(write, 1.0), wait);
+        out << line;
+    }
+}
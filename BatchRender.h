@@ -0,0 +1,81 @@
+#ifndef _BATCH_RENDER_H_
+#define _BATCH_RENDER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Rasterizer.h"
+
+// 离线批量渲染：不创建窗口，对每个模型绕Y轴均匀取 K 个角度，用 SoftwareRasterizer 渲染后写成 BMP
+// 用于生成缩略图和图像回归比对。
+//
+// 流程：
+//   1. 线程池上并行读取各模型的欧拉操作脚本并三角化
+//   2. 每张图像为一个任务，线程池上的线程各自取一个单线程的光栅化器渲染，结果复制到空闲的帧缓冲后排入写出队列
+//   3. 单独的写出线程按完成顺序把帧写入磁盘；帧缓冲个数有限，写出跟不上时渲染任务等待空闲的帧缓冲，
+//      因此渲染与磁盘写入重叠进行，内存占用也不随图像数增长
+// 输出文件名为 <输出目录>/<模型文件名>_<角度序号>.bmp
+
+typedef struct BatchOptions
+{
+    std::vector<std::string> models;   // 欧拉操作脚本路径
+    std::string outputDir = ".";       // 不存在时自动创建
+    int angles = 8;                    // 每个模型的角度数 K
+    int width = 256;
+    int height = 256;
+    float elevation = 0.4f;            // 绕X轴的俯视角（弧度）
+    ShadeMode shade = SHADE_GOURAUD;
+    bool wireframe = false;            // 只画全部边（按折线光栅化），不着色
+    unsigned threads = 0;              // 渲染线程数，0 为硬件线程数
+    size_t frames = 0;                 // 帧缓冲个数（写出队列的深度），0 为渲染线程数的两倍
+} BatchOptions;
+
+// 一张图像的耗时，毫秒
+typedef struct BatchImage
+{
+    std::string path;
+    size_t model = 0;
+    int angle = 0;
+    double waitMs = 0;      // 等待空闲帧缓冲
+    double renderMs = 0;    // 光栅化并复制到帧缓冲
+    double writeMs = 0;     // 编码并写入磁盘
+    bool written = false;
+} BatchImage;
+
+typedef struct BatchReport
+{
+    std::vector<BatchImage> images;        // 按模型、角度排列
+    std::vector<std::string> errors;       // 读取失败的模型、写入失败的图像
+    size_t modelsLoaded = 0;
+    size_t triangles = 0;                  // 所有模型的三角形总数
+    double loadMs = 0;                     // 读取并三角化全部模型
+    double renderWallMs = 0;               // 从开始渲染到最后一帧写完
+    size_t bytesWritten = 0;
+    unsigned threads = 0;
+
+    size_t imagesWritten() const
+    {
+        size_t count = 0;
+        for (const BatchImage& image : images) count += image.written;
+        return count;
+    }
+} BatchReport;
+
+// 解析批量渲染的命令行参数（不含 --batch 本身），未给出的选项保持 options 中的值：
+//     --out 目录  --angles K  --size 宽x高  --threads N  --frames N  --flat  --wire  模型...
+bool parseBatchArguments(const std::vector<std::string>& args, BatchOptions& options, std::string* error);
+
+// 执行批量渲染；参数本身不合法（没有模型、角度数或尺寸不为正、无法创建输出目录）时返回 false
+// 个别模型读取失败或图像写入失败记入 report.errors，其余图像照常输出
+bool runBatchRender(const BatchOptions& options, BatchReport& report, std::string* error);
+
+// 输出每张图像的耗时和汇总的吞吐量
+void printBatchReport(std::ostream& out, const BatchReport& report);
+
+// 把 32 位 BGRA 颜色缓冲写成自顶向下的 32 位 BMP；stride 为每行的像素数
+bool writeBmp(const std::string& path, const uint32_t* pixels, int width, int height, int stride,
+              std::string* error);
+
+#endif // !_BATCH_RENDER_H_
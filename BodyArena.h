@@ -0,0 +1,263 @@
+#ifndef _BODY_ARENA_H_
+#define _BODY_ARENA_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 每个 Body 独享的内存池
+// 拓扑记录（顶点、半边、边、环、面）从大块内存中顺序切分，释放的记录按大小挂入空闲链表复用。
+// 不同 Body 的内存池互不相关，多线程各自构建不同的 Body 时既不需要加锁，也不会争用全局堆；
+// Body 析构时整块归还，不必逐个释放记录。
+// 内存池同时统计存活记录的个数、字节数及其峰值，用于内存占用报告和泄漏检查。
+class BodyArena
+{
+public:
+    // 复制内存池后的地址映射：旧池中的地址 -> 新池中相同偏移处的地址
+    class Relocation
+    {
+    public:
+        template <class T>
+        T* operator()(T* _p) const
+        {
+            if (!_p) return nullptr;
+            const char* addr = reinterpret_cast<const char*>(_p);
+            // 多数实体只有少数几块，按块起始地址二分查找
+            auto it = std::upper_bound(ranges_.begin(), ranges_.end(), addr,
+                [](const char* a, const Range& r) { return a < r.begin_; });
+            if (it == ranges_.begin()) return _p;
+            --it;
+            if (addr >= it->end_) return _p;
+            return reinterpret_cast<T*>(it->target_ + (addr - it->begin_));
+        }
+
+    private:
+        friend class BodyArena;
+        struct Range { const char* begin_; const char* end_; char* target_; };
+        std::vector<Range> ranges_;  // 按 begin_ 升序
+    };
+
+    explicit BodyArena(size_t _first_chunk = 4096)
+        : next_chunk_size_(_first_chunk)
+    {
+        for (auto& head : free_lists_) head = nullptr;
+    }
+
+    ~BodyArena()
+    {
+        release();
+    }
+
+    BodyArena(const BodyArena&) = delete;
+    BodyArena& operator=(const BodyArena&) = delete;
+
+    /** 在池中构造一个对象 */
+    template <class T, class... Args>
+    T* create(Args&&... _args)
+    {
+        static_assert(sizeof(T) <= MAX_RECORD_SIZE, "record too large for BodyArena");
+        void* p = allocate(sizeof(T), alignof(T));
+        live_records_++;
+        live_bytes_ += record_bytes(sizeof(T));
+        if (live_bytes_ > peak_bytes_) peak_bytes_ = live_bytes_;
+        return new (p) T{std::forward<Args>(_args)...};
+    }
+
+    // 一次连续创建的一组记录，相邻记录间隔 record_bytes(sizeof(T)) 字节
+    template <class T>
+    class Block
+    {
+    public:
+        T* operator[](size_t _i) const { return reinterpret_cast<T*>(base_ + _i * record_bytes(sizeof(T))); }
+        size_t size() const { return count_; }
+
+    private:
+        friend class BodyArena;
+        char* base_ = nullptr;
+        size_t count_ = 0;
+    };
+
+    /**
+     * 在一段连续内存中构造 _count 个对象，第 i 个由 _init(i) 的返回值构造
+     * 不查空闲链表，整段只做一次边界检查；每个记录与 create 得到的记录尺寸相同，之后仍可逐个 destroy
+     */
+    template <class T, class Init>
+    Block<T> create_n(size_t _count, Init _init)
+    {
+        static_assert(sizeof(T) <= MAX_RECORD_SIZE, "record too large for BodyArena");
+        static_assert(alignof(T) <= 8, "records in a block are only 8-byte aligned");
+        Block<T> block;
+        if (_count == 0) return block;
+        const size_t stride = record_bytes(sizeof(T));
+        const size_t bytes = stride * _count;
+        if (chunks_.empty() || !fits(chunks_.back(), bytes, alignof(T)))
+        {
+            add_chunk(bytes);
+        }
+        Chunk& chunk = chunks_.back();
+        size_t offset = (chunk.used_ + alignof(T) - 1) & ~(alignof(T) - 1);
+        chunk.used_ = offset + bytes;
+        block.base_ = chunk.data_ + offset;
+        block.count_ = _count;
+        for (size_t i = 0; i < _count; i++) new (block.base_ + i * stride) T(_init(i));
+        live_records_ += _count;
+        live_bytes_ += bytes;
+        if (live_bytes_ > peak_bytes_) peak_bytes_ = live_bytes_;
+        return block;
+    }
+
+    /** 在一段连续内存中值初始化 _count 个对象 */
+    template <class T>
+    Block<T> create_n(size_t _count)
+    {
+        return create_n<T>(_count, [](size_t) { return T{}; });
+    }
+
+    /** 析构对象并把内存挂回同尺寸的空闲链表 */
+    template <class T>
+    void destroy(T* _p)
+    {
+        if (!_p) return;
+        _p->~T();
+        FreeNode* node = reinterpret_cast<FreeNode*>(_p);
+        size_t slot = slot_of(sizeof(T));
+        node->next_ = free_lists_[slot];
+        free_lists_[slot] = node;
+        live_records_--;
+        live_bytes_ -= record_bytes(sizeof(T));
+    }
+
+    /** 预留至少 _bytes 字节的连续空间，避免构建过程中反复申请新块 */
+    void reserve(size_t _bytes)
+    {
+        if (chunks_.empty() || chunks_.back().size_ - chunks_.back().used_ < _bytes)
+        {
+            add_chunk(_bytes);
+        }
+    }
+
+    /** 归还全部内存 */
+    void release()
+    {
+        for (auto& chunk : chunks_) std::free(chunk.data_);
+        chunks_.clear();
+        for (auto& head : free_lists_) head = nullptr;
+        bytes_reserved_ = 0;
+        live_records_ = 0;
+        live_bytes_ = 0;
+    }
+
+    /**
+     * 把 _other 中已使用的内存整体复制到本池（本池须为空），返回地址映射
+     * 复制后的记录仍指向旧池，调用者需用返回的映射逐个修正指针字段
+     */
+    Relocation copy_from(const BodyArena& _other)
+    {
+        release();
+        Relocation reloc;
+        if (_other.chunks_.empty()) return reloc;
+
+        // 所有旧块紧凑地拷贝进一个新块，每段起点按 ALIGNMENT 对齐
+        size_t total = 0;
+        for (const Chunk& chunk : _other.chunks_) total += (chunk.used_ + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        add_chunk(total);
+        Chunk& dst = chunks_.back();
+        for (const Chunk& chunk : _other.chunks_)
+        {
+            std::memcpy(dst.data_ + dst.used_, chunk.data_, chunk.used_);
+            reloc.ranges_.push_back(Relocation::Range{chunk.data_, chunk.data_ + chunk.size_, dst.data_ + dst.used_});
+            dst.used_ += (chunk.used_ + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+        std::sort(reloc.ranges_.begin(), reloc.ranges_.end(),
+                  [](const Relocation::Range& a, const Relocation::Range& b) { return a.begin_ < b.begin_; });
+
+        // 空闲链表随内存一起复制，只需修正链表指针
+        for (size_t slot = 0; slot < sizeof(free_lists_) / sizeof(free_lists_[0]); slot++)
+        {
+            free_lists_[slot] = reloc(_other.free_lists_[slot]);
+            for (FreeNode* node = free_lists_[slot]; node; node = node->next_)
+            {
+                node->next_ = reloc(node->next_);
+            }
+        }
+        next_chunk_size_ = _other.next_chunk_size_;
+        live_records_ = _other.live_records_;
+        live_bytes_ = _other.live_bytes_;
+        peak_bytes_ = std::max(peak_bytes_, _other.live_bytes_);
+        return reloc;
+    }
+
+    /** 向系统申请的总字节数 */
+    size_t bytes_reserved() const { return bytes_reserved_; }
+    /** 存活记录占用的字节数（按池内的取整尺寸计） */
+    size_t bytes_live() const { return live_bytes_; }
+    /** bytes_live 自内存池创建以来的最大值 */
+    size_t bytes_peak() const { return peak_bytes_; }
+    size_t records_live() const { return live_records_; }
+
+    /** 一个 _size 字节的记录在池中实际占用的字节数 */
+    static size_t record_bytes(size_t _size) { return slot_of(_size) * 8; }
+
+private:
+    static const size_t ALIGNMENT = alignof(std::max_align_t);
+    static const size_t MAX_RECORD_SIZE = 128;
+    static const size_t MAX_CHUNK_SIZE = 1 << 20;
+
+    struct FreeNode { FreeNode* next_; };
+    struct Chunk { char* data_; size_t size_; size_t used_; };
+
+    static size_t slot_of(size_t _size) { return (_size + 7) / 8; }
+
+    void* allocate(size_t _size, size_t _align)
+    {
+        // 按8字节向上取整，保证同一空闲链表中的内存块可以互相替用
+        size_t slot = slot_of(_size);
+        _size = slot * 8;
+        if (FreeNode* node = free_lists_[slot])
+        {
+            free_lists_[slot] = node->next_;
+            return node;
+        }
+
+        if (chunks_.empty() || !fits(chunks_.back(), _size, _align))
+        {
+            add_chunk(_size);
+        }
+        Chunk& chunk = chunks_.back();
+        size_t offset = (chunk.used_ + _align - 1) & ~(_align - 1);
+        chunk.used_ = offset + _size;
+        return chunk.data_ + offset;
+    }
+
+    static bool fits(const Chunk& _chunk, size_t _size, size_t _align)
+    {
+        size_t offset = (_chunk.used_ + _align - 1) & ~(_align - 1);
+        return offset + _size <= _chunk.size_;
+    }
+
+    void add_chunk(size_t _min_size)
+    {
+        size_t size = next_chunk_size_;
+        while (size < _min_size + ALIGNMENT) size *= 2;
+        char* data = static_cast<char*>(std::malloc(size));
+        if (!data) throw std::bad_alloc();
+        chunks_.push_back(Chunk{data, size, 0});
+        bytes_reserved_ += size;
+        // 块大小倍增直至上限，大模型只需少量几块
+        if (next_chunk_size_ < MAX_CHUNK_SIZE) next_chunk_size_ *= 2;
+    }
+
+    std::vector<Chunk> chunks_;
+    FreeNode* free_lists_[MAX_RECORD_SIZE / 8 + 1];
+    size_t next_chunk_size_;
+    size_t bytes_reserved_ = 0;
+    size_t live_records_ = 0;
+    size_t live_bytes_ = 0;
+    size_t peak_bytes_ = 0;
+};
+
+#endif // !_BODY_ARENA_H_
@@ -0,0 +1,30 @@
+#include "BodyBuilder.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+std::vector<Body*> buildBodiesParallel(ThreadPool& _pool, size_t _count, const BodyRecipe& _recipe) {
+    std::vector<Body*> bodies(_count, nullptr);
+    if (_count == 0) return bodies;
+
+    // 每个线程分到若干批，批内连续构建，既均衡负载又减少任务队列的加锁次数
+    size_t batches = std::min<size_t>(_count, (size_t)_pool.size() * 8);
+    for (size_t b = 0; b < batches; b++) {
+        size_t begin = _count * b / batches;
+        size_t end = _count * (b + 1) / batches;
+        _pool.submit([&bodies, &_recipe, begin, end] {
+            for (size_t i = begin; i < end; i++) {
+                EulerOperations ops;
+                ops.set_verbose(false);
+                try {
+                    _recipe(ops, i);
+                    bodies[i] = ops.release_body();
+                } catch (const std::exception& e) {
+                    std::cerr << "buildBodiesParallel: 第 " << i << " 个实体构建失败: " << e.what() << std::endl;
+                }
+            }
+        });
+    }
+    _pool.wait();
+    return bodies;
+}
@@ -0,0 +1,19 @@
+#ifndef _BODY_BUILDER_H_
+#define _BODY_BUILDER_H_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "EulerOperations.h"
+#include "ThreadPool.h"
+
+// 构建单个实体的步骤：在给定的 EulerOperations 上从 mvfs 开始执行欧拉操作
+// 第二个参数为实体的序号，可用于区分不同零件的参数
+typedef std::function<void(EulerOperations&, size_t)> BodyRecipe;
+
+// 在线程池上并行构建 _count 个相互独立的实体
+// 每个实体由独立的 EulerOperations 构建，记录分配在各自 Body 的内存池中，线程之间不共享可变状态。
+// 返回值按序号排列，所有权交给调用者；构建失败（未调用 mvfs 或抛出异常）的位置为 nullptr
+std::vector<Body*> buildBodiesParallel(ThreadPool& _pool, size_t _count, const BodyRecipe& _recipe);
+
+#endif // !_BODY_BUILDER_H_
@@ -0,0 +1,79 @@
+#include "BodySnapshot.h"
+
+Body* cloneBody(const Body* _body) {
+    if (!_body) return nullptr;
+
+    Body* clone = new Body;
+    BodyArena::Relocation reloc = clone->arena_.copy_from(_body->arena_);
+
+    clone->face_num_ = _body->face_num_;
+    clone->edge_num_ = _body->edge_num_;
+    clone->vertex_num_ = _body->vertex_num_;
+    clone->revision_ = _body->revision_;
+
+    // 顶点
+    clone->vertices_.resize(_body->vertices_.size());
+    for (size_t i = 0; i < _body->vertices_.size(); i++) {
+        Vertex* v = reloc(_body->vertices_[i]);
+        v->he_ = reloc(v->he_);
+        clone->vertices_[i] = v;
+    }
+
+    // 边及其两个半边（所有有效半边都挂在某条边上）
+    clone->edges_.resize(_body->edges_.size());
+    for (size_t i = 0; i < _body->edges_.size(); i++) {
+        Edge* e = reloc(_body->edges_[i]);
+        e->he0_ = reloc(e->he0_);
+        e->he1_ = reloc(e->he1_);
+        for (Halfedge* he : {e->he0_, e->he1_}) {
+            if (!he) continue;
+            he->start_vertex_ = reloc(he->start_vertex_);
+            he->to_vertex_ = reloc(he->to_vertex_);
+            he->next_he_ = reloc(he->next_he_);
+            he->prev_he_ = reloc(he->prev_he_);
+            he->oppo_he_ = reloc(he->oppo_he_);
+            he->edge_ = e;
+            he->loop_ = reloc(he->loop_);
+        }
+        clone->edges_[i] = e;
+    }
+
+    // 面和环
+    clone->first_face_ = reloc(_body->first_face_);
+    for (Face* f = clone->first_face_; f; f = f->next_face_) {
+        f->first_loop_ = reloc(f->first_loop_);
+        f->next_face_ = reloc(f->next_face_);
+        f->prev_face_ = reloc(f->prev_face_);
+        f->body_ = clone;
+        for (Loop* lp = f->first_loop_; lp; lp = lp->next_loop_) {
+            lp->start_he_ = reloc(lp->start_he_);
+            lp->next_loop_ = reloc(lp->next_loop_);
+            lp->prev_loop_ = reloc(lp->prev_loop_);
+            lp->face_ = f;
+        }
+    }
+
+    return clone;
+}
+
+std::shared_ptr<const Body> SnapshotPublisher::publish(const Body* _body) {
+    if (!_body) return latest();
+
+    // 实体未被修改，沿用上一个版本
+    if (_body->id_ == source_id_ && _body->revision_ == source_revision_) {
+        return latest();
+    }
+
+    std::shared_ptr<const Body> snapshot(cloneBody(_body));
+    source_id_ = _body->id_;
+    source_revision_ = _body->revision_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    latest_ = snapshot;
+    return snapshot;
+}
+
+std::shared_ptr<const Body> SnapshotPublisher::latest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_;
+}
@@ -0,0 +1,32 @@
+#ifndef _BODY_SNAPSHOT_H_
+#define _BODY_SNAPSHOT_H_
+
+#include <memory>
+#include <mutex>
+#include "SolidModel.h"
+
+// 深拷贝一个实体，时间与实体规模成线性关系
+// 先把源实体的内存池整体 memcpy 到新池，再按地址映射逐个修正记录中的指针，
+// 不做逐记录分配，也不需要哈希表记录新旧对应关系
+Body* cloneBody(const Body* _body);
+
+// 只读快照的发布者：写者持有可变的 Body 并继续执行欧拉操作，读者拿到的是不可变的版本
+// - 写者线程调用 publish() 发布当前状态；若仍是同一个实体（id_ 相同）且自上次发布以来没有被修改（revision_ 未变），
+//   直接复用上一个版本而不复制，即只有写入之后的发布才会产生拷贝
+// - 任意线程调用 latest() 取得最近发布的版本，持有 shared_ptr 期间该版本保持不变，
+//   最后一个持有者释放时自动回收
+// 写者手中的 Vertex*/Loop* 等句柄始终指向自己的实体，不受发布影响
+class SnapshotPublisher
+{
+public:
+    std::shared_ptr<const Body> publish(const Body* _body);
+    std::shared_ptr<const Body> latest() const;
+
+private:
+    mutable std::mutex mutex_;              // 只保护 latest_ 的交换，复制在锁外进行
+    std::shared_ptr<const Body> latest_;
+    unsigned long long source_id_ = 0;      // 上次发布的源实体编号（Body::id_）及其版本号（仅写者线程访问）
+    unsigned long long source_revision_ = 0;
+};
+
+#endif // !_BODY_SNAPSHOT_H_
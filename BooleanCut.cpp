@@ -0,0 +1,427 @@
+#include "BooleanCut.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Predicates.h"
+#include "Topology.h"
+
+namespace {
+
+inline Point sub(const Point& a, const Point& b) { return Point(a[0] - b[0], a[1] - b[1], a[2] - b[2]); }
+inline Point along(const Point& p, const Point& d, double t) { return Point(p[0] + t * d[0], p[1] + t * d[1], p[2] + t * d[2]); }
+inline double dot(const Point& a, const Point& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+inline Point cross(const Point& a, const Point& b) {
+    return Point(a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]);
+}
+
+inline bool setError(std::string* _error, const char* _message) {
+    if (_error) *_error = _message;
+    return false;
+}
+
+enum Location { OUTSIDE, INSIDE, BOUNDARY };
+
+// 二维线段，坐标取自面所在平面的投影
+struct Segment2 {
+    double a[2];
+    double b[2];
+};
+
+inline bool between(double v, double a, double b) {
+    return a < b ? (a <= v && v <= b) : (b <= v && v <= a);
+}
+
+// 已知 p 与 a、b 共线，判断 p 是否在线段 ab 上
+inline bool onSegment(const double* a, const double* b, const double* p) {
+    return between(p[0], a[0], b[0]) && between(p[1], a[1], b[1]);
+}
+
+// 点相对于一组有向边围成区域的位置（奇偶规则），落在任意边上即为 BOUNDARY
+Location locate(const Segment2* _begin, const Segment2* _end, const double* q) {
+    bool inside = false;
+    for (const Segment2* s = _begin; s != _end; s++) {
+        if (between(q[0], s->a[0], s->b[0]) && between(q[1], s->a[1], s->b[1]) && orient2d(s->a, s->b, q) == 0) {
+            return BOUNDARY;
+        }
+        bool upward = s->b[1] > s->a[1];
+        if ((s->a[1] > q[1]) == (s->b[1] > q[1])) continue;
+        // 向上的边在 q 左侧看时交点位于 q 右侧，向下的边相反
+        if ((orient2d(s->a, s->b, q) > 0) == upward) inside = !inside;
+    }
+    return inside ? INSIDE : OUTSIDE;
+}
+
+// 两条闭线段是否有公共点
+bool segmentsTouch(const double* p1, const double* p2, const double* q1, const double* q2) {
+    double d1 = orient2d(q1, q2, p1), d2 = orient2d(q1, q2, p2);
+    double d3 = orient2d(p1, p2, q1), d4 = orient2d(p1, p2, q2);
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) return true;
+    if (d1 == 0 && onSegment(q1, q2, p1)) return true;
+    if (d2 == 0 && onSegment(q1, q2, p2)) return true;
+    if (d3 == 0 && onSegment(p1, p2, q1)) return true;
+    if (d4 == 0 && onSegment(p1, p2, q2)) return true;
+    return false;
+}
+
+// 面的平面与二维投影
+// 法向取最大环的 Newell 法向（与外环绕向一致），投影时丢掉法向的主分量，并让外环在二维中为逆时针
+struct FacePlane {
+    Loop* outer = nullptr;
+    Point normal = Point(0, 0, 0);
+    const double* basis[3] = {nullptr, nullptr, nullptr};   // 外环上张成平面的三个顶点，供 orient3d 使用
+    int u = 0;
+    int v = 1;
+    std::vector<Segment2> edges;   // 所有环的边，按环连续存放
+
+    // 每个环在 edges 中的范围及其二维包围盒；环互不相交，点对各环的奇偶性可以分别计算，
+    // 因此包围盒不含该点（或不与查询窗口相交）的环可以整个跳过，内环很多的面上查询只触及附近的环
+    struct LoopRange {
+        size_t begin;
+        size_t end;
+        double min[2];
+        double max[2];
+    };
+    std::vector<LoopRange> ranges;
+
+    explicit FacePlane(const Face* _face) {
+        double best = -1;
+        for (Loop* loop : loops(_face)) {
+            Point n(0, 0, 0);
+            for (Halfedge* he : halfedges(loop)) {
+                const Point& a = he->start_vertex_->p_;
+                const Point& b = he->to_vertex_->p_;
+                n[0] += (a[1] - b[1]) * (a[2] + b[2]);
+                n[1] += (a[2] - b[2]) * (a[0] + b[0]);
+                n[2] += (a[0] - b[0]) * (a[1] + b[1]);
+            }
+            double len = dot(n, n);
+            if (len > best) {
+                best = len;
+                normal = n;
+                outer = loop;
+            }
+        }
+        if (!outer || best <= 0) return;
+
+        int k = 0;
+        for (int i = 1; i < 3; i++) {
+            if (std::fabs(normal[i]) > std::fabs(normal[k])) k = i;
+        }
+        u = (k + 1) % 3;
+        v = (k + 2) % 3;
+        if (normal[k] < 0) std::swap(u, v);
+
+        // 第一个顶点、离它最远的顶点、离两者连线最远的顶点
+        const Point& p0 = outer->start_he_->start_vertex_->p_;
+        const Point* p1 = &p0;
+        const Point* p2 = &p0;
+        double farthest = 0;
+        for (Vertex* vx : loopVertices(outer)) {
+            Point d = sub(vx->p_, p0);
+            if (dot(d, d) > farthest) {
+                farthest = dot(d, d);
+                p1 = &vx->p_;
+            }
+        }
+        Point axis = sub(*p1, p0);
+        farthest = 0;
+        for (Vertex* vx : loopVertices(outer)) {
+            Point c = cross(axis, sub(vx->p_, p0));
+            if (dot(c, c) > farthest) {
+                farthest = dot(c, c);
+                p2 = &vx->p_;
+            }
+        }
+        // 让 basis 的绕向与法向一致，orient3d 的符号才有统一含义
+        if (dot(cross(axis, sub(*p2, p0)), normal) < 0) std::swap(p1, p2);
+        basis[0] = p0.coordinate_;
+        basis[1] = p1->coordinate_;
+        basis[2] = p2->coordinate_;
+
+        for (Loop* loop : loops(_face)) {
+            LoopRange range = {edges.size(), edges.size(), {0, 0}, {0, 0}};
+            for (Halfedge* he : halfedges(loop)) {
+                Segment2 s;
+                project(he->start_vertex_->p_, s.a);
+                project(he->to_vertex_->p_, s.b);
+                for (int k = 0; k < 2; k++) {
+                    if (edges.size() == range.begin || s.a[k] < range.min[k]) range.min[k] = s.a[k];
+                    if (edges.size() == range.begin || s.a[k] > range.max[k]) range.max[k] = s.a[k];
+                }
+                edges.push_back(s);
+            }
+            range.end = edges.size();
+            ranges.push_back(range);
+        }
+    }
+
+    bool valid() const { return basis[0] != nullptr; }
+    void project(const Point& p, double* out) const { out[0] = p[u]; out[1] = p[v]; }
+
+    // 沿 d 过 p 的直线与平面的交点参数，平行时返回 false
+    bool intersect(const Point& p, const Point& d, double& t) const {
+        double denom = dot(normal, d);
+        if (denom == 0) return false;
+        t = dot(normal, sub(Point(basis[0]), p)) / denom;
+        return true;
+    }
+
+    // 对包围盒与 [lo, hi] 相交的每个环调用 _fn(begin, end)
+    template <class Fn>
+    void nearby(const double* lo, const double* hi, Fn _fn) const {
+        for (const LoopRange& r : ranges) {
+            if (r.max[0] < lo[0] || hi[0] < r.min[0] || r.max[1] < lo[1] || hi[1] < r.min[1]) continue;
+            _fn(edges.data() + r.begin, edges.data() + r.end);
+        }
+    }
+
+    Location locate(const Point& p) const {
+        double q[2];
+        project(p, q);
+        bool inside = false;
+        bool boundary = false;
+        nearby(q, q, [&](const Segment2* _begin, const Segment2* _end) {
+            Location where = ::locate(_begin, _end, q);
+            if (where == BOUNDARY) boundary = true;
+            if (where == INSIDE) inside = !inside;
+        });
+        return boundary ? BOUNDARY : (inside ? INSIDE : OUTSIDE);
+    }
+};
+
+// 闭线段 se 与面（含内环）是否有公共点
+bool segmentTouchesFace(const Point& s, const Point& e, const FacePlane& _plane) {
+    double o1 = orient3d(_plane.basis[0], _plane.basis[1], _plane.basis[2], s.coordinate_);
+    double o2 = orient3d(_plane.basis[0], _plane.basis[1], _plane.basis[2], e.coordinate_);
+    if ((o1 > 0 && o2 > 0) || (o1 < 0 && o2 < 0)) return false;
+    if (o1 == 0 && o2 == 0) {
+        if (_plane.locate(s) != OUTSIDE || _plane.locate(e) != OUTSIDE) return true;
+        double a[2], b[2];
+        _plane.project(s, a);
+        _plane.project(e, b);
+        double lo[2] = {std::min(a[0], b[0]), std::min(a[1], b[1])};
+        double hi[2] = {std::max(a[0], b[0]), std::max(a[1], b[1])};
+        bool touch = false;
+        _plane.nearby(lo, hi, [&](const Segment2* _begin, const Segment2* _end) {
+            for (const Segment2* edge = _begin; edge != _end && !touch; edge++) {
+                touch = segmentsTouch(a, b, edge->a, edge->b);
+            }
+        });
+        return touch;
+    }
+    double t = o1 / (o1 - o2);
+    return _plane.locate(along(s, sub(e, s), t)) != OUTSIDE;
+}
+
+// 闭线段 se 与三角形 abc 是否有公共点
+bool segmentTouchesTriangle(const Point& s, const Point& e, const Point& a, const Point& b, const Point& c) {
+    double o1 = orient3d(a.coordinate_, b.coordinate_, c.coordinate_, s.coordinate_);
+    double o2 = orient3d(a.coordinate_, b.coordinate_, c.coordinate_, e.coordinate_);
+    if ((o1 > 0 && o2 > 0) || (o1 < 0 && o2 < 0)) return false;
+    if (o1 == 0 && o2 == 0) {
+        // 共面：丢掉三角形法向的主分量后做二维判断
+        Point n = cross(sub(b, a), sub(c, a));
+        int k = 0;
+        for (int i = 1; i < 3; i++) {
+            if (std::fabs(n[i]) > std::fabs(n[k])) k = i;
+        }
+        int u = (k + 1) % 3, v = (k + 2) % 3;
+        double s2[2] = {s[u], s[v]}, e2[2] = {e[u], e[v]};
+        double tri[3][2] = {{a[u], a[v]}, {b[u], b[v]}, {c[u], c[v]}};
+        for (int i = 0; i < 3; i++) {
+            if (segmentsTouch(s2, e2, tri[i], tri[(i + 1) % 3])) return true;
+        }
+        double w0 = orient2d(tri[0], tri[1], s2), w1 = orient2d(tri[1], tri[2], s2), w2 = orient2d(tri[2], tri[0], s2);
+        return (w0 >= 0 && w1 >= 0 && w2 >= 0) || (w0 <= 0 && w1 <= 0 && w2 <= 0);
+    }
+    // 直线 se 穿过三角形当且仅当它绕三条边的方向不出现异号
+    double e1 = orient3d(s.coordinate_, e.coordinate_, a.coordinate_, b.coordinate_);
+    double e2 = orient3d(s.coordinate_, e.coordinate_, b.coordinate_, c.coordinate_);
+    double e3 = orient3d(s.coordinate_, e.coordinate_, c.coordinate_, a.coordinate_);
+    bool positive = e1 > 0 || e2 > 0 || e3 > 0;
+    bool negative = e1 < 0 || e2 < 0 || e3 < 0;
+    return !(positive && negative);
+}
+
+// 截面多边形在某个面平面上的投影必须严格位于面内，且与面上已有的环互不相交、互不包含
+bool ringFitsFace(const std::vector<Point>& _ring, const FacePlane& _plane) {
+    size_t n = _ring.size();
+    std::vector<Segment2> ring(n);
+    double lo[2], hi[2];
+    for (size_t i = 0; i < n; i++) {
+        _plane.project(_ring[i], ring[i].a);
+        _plane.project(_ring[(i + 1) % n], ring[i].b);
+        for (int k = 0; k < 2; k++) {
+            if (i == 0 || ring[i].a[k] < lo[k]) lo[k] = ring[i].a[k];
+            if (i == 0 || ring[i].a[k] > hi[k]) hi[k] = ring[i].a[k];
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (_plane.locate(_ring[i]) != INSIDE) return false;
+    }
+    bool fits = true;
+    _plane.nearby(lo, hi, [&](const Segment2* _begin, const Segment2* _end) {
+        for (const Segment2* edge = _begin; edge != _end && fits; edge++) {
+            for (size_t i = 0; i < n && fits; i++) {
+                fits = !segmentsTouch(ring[i].a, ring[i].b, edge->a, edge->b);
+            }
+            if (fits) fits = locate(ring.data(), ring.data() + n, edge->a) == OUTSIDE;
+        }
+    });
+    return fits;
+}
+
+} // namespace
+
+ThroughHoleCutter::ThroughHoleCutter(EulerOperations& _ops) : ops_(_ops) {
+    tree_.build(ops_.get_body());
+}
+
+bool ThroughHoleCutter::cut(const std::vector<Point>& _profile, const Point& _direction, std::string* _error) {
+    Body* body = ops_.get_body();
+    size_t n = _profile.size();
+    if (!body || !body->first_face_) return setError(_error, "没有可开孔的实体");
+    if (n < 3) return setError(_error, "截面至少需要3个顶点");
+    if (dot(_direction, _direction) == 0) return setError(_error, "开孔方向为零向量");
+    for (size_t i = 0; i < n; i++) {
+        Point d = sub(_profile[(i + 1) % n], _profile[i]);
+        if (dot(d, d) == 0) return setError(_error, "截面有重合的相邻顶点");
+    }
+
+    // 1. 刀具轴线（过截面形心）与实体的交点：用包围盒树筛出候选面，再逐个求交
+    Point center(0, 0, 0);
+    for (const Point& p : _profile) {
+        for (int k = 0; k < 3; k++) center[k] += p[k] / n;
+    }
+    auto lineHitsBox = [&](const AABB& _box) {
+        double tmin = -std::numeric_limits<double>::infinity();
+        double tmax = std::numeric_limits<double>::infinity();
+        for (int k = 0; k < 3; k++) {
+            double pad = 1e-9 * (1 + std::fabs(_box.min[k]) + std::fabs(_box.max[k]));
+            double lo = _box.min[k] - pad, hi = _box.max[k] + pad;
+            if (_direction[k] == 0) {
+                if (center[k] < lo || center[k] > hi) return false;
+                continue;
+            }
+            double t0 = (lo - center[k]) / _direction[k];
+            double t1 = (hi - center[k]) / _direction[k];
+            if (t0 > t1) std::swap(t0, t1);
+            tmin = std::max(tmin, t0);
+            tmax = std::min(tmax, t1);
+            if (tmin > tmax) return false;
+        }
+        return true;
+    };
+
+    struct Crossing {
+        Face* face;
+        double t;
+    };
+    std::vector<Crossing> crossings;
+    bool grazing = false;
+    tree_.query(lineHitsBox, [&](Face* _face) {
+        FacePlane plane(_face);
+        double t;
+        if (!plane.valid() || !plane.intersect(center, _direction, t)) return;
+        Location where = plane.locate(along(center, _direction, t));
+        if (where == BOUNDARY) grazing = true;
+        if (where == INSIDE) crossings.push_back({_face, t});
+    });
+    if (grazing) return setError(_error, "刀具轴线经过实体的边或顶点");
+    if (crossings.size() != 2) return setError(_error, "刀具轴线必须恰好穿过实体的两个面");
+    if (crossings[0].face == crossings[1].face) return setError(_error, "刀具轴线两次穿过同一个面");
+    if (crossings[0].t > crossings[1].t) std::swap(crossings[0], crossings[1]);
+
+    FacePlane entry(crossings[0].face), exitPlane(crossings[1].face);
+    double inDot = dot(entry.normal, _direction), outDot = dot(exitPlane.normal, _direction);
+    if (!(inDot < 0 && outDot > 0)) return setError(_error, "入口面与出口面的朝向不一致");
+
+    // 2. 截面沿方向投影到入口面与出口面，孔口在入口面上按其法向逆时针排列
+    std::vector<Point> top, bottom;
+    top.reserve(n);
+    bottom.reserve(n);
+    for (const Point& p : _profile) {
+        double t0, t1;
+        if (!entry.intersect(p, _direction, t0) || !exitPlane.intersect(p, _direction, t1)) {
+            return setError(_error, "截面投影与入口面或出口面平行");
+        }
+        if (t0 >= t1) return setError(_error, "截面投影后入口在出口之后");
+        top.push_back(along(p, _direction, t0));
+        bottom.push_back(along(p, _direction, t1));
+    }
+    double area = 0;
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        double a[2], b[2];
+        entry.project(top[j], a);
+        entry.project(top[i], b);
+        area += a[0] * b[1] - b[0] * a[1];
+    }
+    if (area == 0) return setError(_error, "截面投影后退化");
+    if (area < 0) {
+        std::reverse(top.begin(), top.end());
+        std::reverse(bottom.begin(), bottom.end());
+    }
+    if (!ringFitsFace(top, entry)) return setError(_error, "孔口超出入口面或与入口面上的环相交");
+    if (!ringFitsFace(bottom, exitPlane)) return setError(_error, "孔口超出出口面或与出口面上的环相交");
+
+    // 3. 孔壁不得与其他面相交：孔壁的棱与候选面求交，候选面的边与孔壁三角形求交
+    AABB tube;
+    for (size_t i = 0; i < n; i++) {
+        tube.expand(top[i]);
+        tube.expand(bottom[i]);
+    }
+    bool blocked = false;
+    tree_.query_box(tube, [&](Face* _face) {
+        if (blocked || _face == entry.outer->face_ || _face == exitPlane.outer->face_) return;
+        FacePlane plane(_face);
+        if (!plane.valid()) return;
+        for (size_t i = 0; i < n && !blocked; i++) {
+            size_t j = (i + 1) % n;
+            blocked = segmentTouchesFace(top[i], bottom[i], plane) ||
+                      segmentTouchesFace(top[i], top[j], plane) ||
+                      segmentTouchesFace(bottom[i], bottom[j], plane);
+        }
+        for (Loop* loop : loops(_face)) {
+            for (Halfedge* he : halfedges(loop)) {
+                const Point& s = he->start_vertex_->p_;
+                const Point& e = he->to_vertex_->p_;
+                for (size_t i = 0; i < n && !blocked; i++) {
+                    size_t j = (i + 1) % n;
+                    blocked = segmentTouchesTriangle(s, e, top[i], top[j], bottom[j]) ||
+                              segmentTouchesTriangle(s, e, top[i], bottom[j], bottom[i]);
+                }
+                if (blocked) return;
+            }
+        }
+    });
+    if (blocked) return setError(_error, "孔壁与实体的其他面相交");
+
+    // 4. 欧拉操作：入口面上画出孔口并分出孔口面，删去桥边成为内环；孔口面扫到出口面后变为出口面的内环
+    // 以上检查通过后这些操作不应失败；若失败则是内部错误，已执行的操作不会撤销，实体处于开了一半孔的状态
+    Loop* outer = entry.outer;
+    Vertex* anchor = outer->start_he_->start_vertex_;
+    std::vector<Vertex*> tv(n), bv(n);
+    for (size_t i = 0; i < n; i++) {
+        tv[i] = ops_.new_vertex(top[i]);
+        if (!ops_.mev(i == 0 ? anchor : tv[i - 1], tv[i], outer)) return setError(_error, "内部错误: mev 失败，实体已被部分修改");
+    }
+    Loop* cap = ops_.mef(tv[0], tv[n - 1], outer);
+    if (!cap || !ops_.kemr(anchor, tv[0], outer)) return setError(_error, "内部错误: 开孔口失败，实体已被部分修改");
+
+    std::vector<Face*> walls;
+    walls.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        bv[i] = ops_.new_vertex(bottom[i]);
+        if (!ops_.mev(tv[i], bv[i], cap)) return setError(_error, "内部错误: mev 失败，实体已被部分修改");
+    }
+    for (size_t i = 0; i < n; i++) {
+        Loop* wall = ops_.mef(bv[i], bv[(i + 1) % n], cap);
+        if (!wall) return setError(_error, "内部错误: mef 失败，实体已被部分修改");
+        walls.push_back(wall->face_);
+    }
+    ops_.kfmrh(exitPlane.outer, cap);
+
+    for (Face* wall : walls) tree_.insert(wall);
+    hole_count_++;
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef _BOOLEAN_CUT_H_
+#define _BOOLEAN_CUT_H_
+
+#include <string>
+#include <vector>
+#include "EulerOperations.h"
+#include "FaceTree.h"
+
+// 约束条件下的布尔差：从平面多面体中减去一个贯穿的棱柱，开出通孔
+//
+// 刀具为截面多边形 _profile 沿 _direction 两端无限延伸的棱柱。约束：
+//   - 刀具轴线（过截面形心）恰好穿过实体的两个面：入口面和出口面
+//   - 截面沿 _direction 投影到两个面的平面上后严格位于面内，不与面上已有的环相交，也不包含已有的环
+//   - 孔壁不与其他任何面相交或接触
+// 满足约束时用欧拉操作构造孔：在入口面上 mev 桥边、mev 画出孔口、mef 分出孔口面、kemr 删去桥边得到内环，
+// 再把孔口面沿 _direction 扫到出口面（mev + mef 生成孔壁），最后 kfmrh 把它变成出口面的内环，实体亏格加一。
+// 不满足约束时实体保持不变。约束检查全部在欧拉操作之前完成，检查通过后欧拉操作不应失败；
+// 若仍然失败（错误信息以“内部错误”开头），已执行的操作不会撤销，实体处于开了一半孔的状态，不应再使用。
+//
+// 面对的剔除使用 FaceTree，所有相交和包含判断都用 Predicates 中的鲁棒谓词
+class ThroughHoleCutter
+{
+public:
+    // 对 _ops 当前的体开孔；期间不要通过其他途径修改该体，否则需重新构造
+    explicit ThroughHoleCutter(EulerOperations& _ops);
+
+    // 成功时返回 true；失败时返回 false 并在 _error 中说明违反的约束
+    bool cut(const std::vector<Point>& _profile, const Point& _direction, std::string* _error = nullptr);
+
+    int hole_count() const { return hole_count_; }
+
+private:
+    EulerOperations& ops_;
+    FaceTree tree_;
+    int hole_count_ = 0;
+};
+
+#endif // !_BOOLEAN_CUT_H_
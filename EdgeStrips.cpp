@@ -0,0 +1,78 @@
+#include "EdgeStrips.h"
+#include <unordered_set>
+#include "FeatureEdges.h"
+#include "Topology.h"
+
+void buildEdgeStrips(const Body* body, EdgeStrips& strips) {
+    strips.clear();
+    if (!body) return;
+
+    // 每个顶点尚未使用的可绘制边数
+    std::vector<uint32_t> remaining(body->vertices_.size(), 0);
+    size_t edgeTotal = 0;
+    for (const Edge* e : body->edges_) {
+        if (!isDrawableEdge(e)) continue;
+        remaining[e->he0_->start_vertex_->id_]++;
+        remaining[e->he0_->to_vertex_->id_]++;
+        edgeTotal++;
+    }
+    strips.vertices.reserve(edgeTotal * 2);
+    strips.offsets.reserve(edgeTotal + 1);
+    strips.offsets.push_back(0);
+
+    std::unordered_set<const Edge*> used;
+    used.reserve(edgeTotal);
+    auto take = [&](const Edge* e) {
+        used.insert(e);
+        remaining[e->he0_->start_vertex_->id_]--;
+        remaining[e->he0_->to_vertex_->id_]--;
+    };
+    auto endStrip = [&]() {
+        if (strips.vertices.size() - strips.offsets.back() < 2) {
+            strips.vertices.resize(strips.offsets.back());
+        } else {
+            strips.offsets.push_back((uint32_t)strips.vertices.size());
+        }
+    };
+
+    // 从 _start 出发，每到一个顶点取第一条未使用的边继续，直到无边可走
+    auto walk = [&](const Vertex* _start) {
+        strips.vertices.push_back((uint32_t)_start->id_);
+        const Vertex* v = _start;
+        while (remaining[v->id_] > 0) {
+            const Halfedge* next = nullptr;
+            for (const Halfedge* he : outgoingHalfedges(v)) {
+                if (isDrawableEdge(he->edge_) && !used.count(he->edge_)) {
+                    next = he;
+                    break;
+                }
+            }
+            if (!next) break;  // 剩余的边不在这个顶点的半边环上（非流形），留给最后一轮
+            take(next->edge_);
+            v = next->to_vertex_;
+            strips.vertices.push_back((uint32_t)v->id_);
+        }
+        endStrip();
+    };
+
+    for (const Vertex* v : body->vertices_) {
+        if (v && remaining[v->id_] % 2 == 1) walk(v);
+    }
+    for (const Vertex* v : body->vertices_) {
+        while (v && remaining[v->id_] > 0) {
+            size_t before = strips.vertices.size();
+            walk(v);
+            if (strips.vertices.size() == before) break;
+        }
+    }
+    // 沿半边邻接走不到的边各自成为一条折线
+    for (const Edge* e : body->edges_) {
+        if (!isDrawableEdge(e) || used.count(e)) continue;
+        take(e);
+        strips.vertices.push_back((uint32_t)e->he0_->start_vertex_->id_);
+        strips.vertices.push_back((uint32_t)e->he0_->to_vertex_->id_);
+        endStrip();
+    }
+    strips.vertices.shrink_to_fit();
+    strips.offsets.shrink_to_fit();
+}
@@ -0,0 +1,34 @@
+#ifndef _EDGE_STRIPS_H_
+#define _EDGE_STRIPS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SolidModel.h"
+
+// 把实体的边串成尽量长的折线
+// 逐条提交的线段在共享顶点处要重复投影、裁剪和提交，折线中每个顶点只处理一次。
+// 在顶点处沿半边邻接（outgoingHalfedges）找下一条尚未使用的边，走到无边可走为止；
+// 一笔画的折线只能在奇度顶点处开始和结束，因此先从剩余度数为奇数的顶点出发，再从其余顶点出发收尾闭合的部分。
+// 每条可绘制的边（见 isDrawableEdge）恰好出现在一条折线中，顶点下标为 Vertex::id_，与 VisualBody、TriangleMesh 的顶点一致。
+typedef struct EdgeStrips
+{
+    std::vector<uint32_t> vertices;   // 各折线的顶点下标，依次排列；相邻两个顶点之间为一条边
+    std::vector<uint32_t> offsets;    // 第 s 条折线为 vertices[offsets[s], offsets[s+1])
+
+    size_t stripCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t edgeCount() const { return vertices.size() - stripCount(); }
+
+    /** 各数组已分配的字节数 */
+    size_t memoryBytes() const { return (vertices.capacity() + offsets.capacity()) * sizeof(uint32_t); }
+
+    void clear()
+    {
+        vertices.clear();
+        offsets.clear();
+    }
+} EdgeStrips;
+
+void buildEdgeStrips(const Body* body, EdgeStrips& strips);
+
+#endif // !_EDGE_STRIPS_H_
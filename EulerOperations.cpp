@@ -1,16 +1,14 @@
 #include "EulerOperations.h"
+#include "Topology.h"
+#include "EulerScript.h"
 #include <iostream>
 
+// 调试输出，批量构建时可通过 set_verbose(false) 关闭
+#define EULER_LOG(msg) do { if (verbose_) std::cout << msg << std::endl; } while (0)
+
 Vertex* EulerOperations::mvfs(const Point& _p)
 {
-    std::cout << "[DEBUG] mvfs操作开始，创建初始顶点" << std::endl;
-    
-    // 创建顶点
-    Vertex* v = new Vertex{_p, nullptr};
-    if (!v) {
-        std::cout << "[ERROR] mvfs: 无法创建顶点" << std::endl;
-        return nullptr;
-    }
+    EULER_LOG("[DEBUG] mvfs操作开始，创建初始顶点");
     
     // 创建体
     if (body_ != nullptr)
@@ -18,25 +16,16 @@ Vertex* EulerOperations::mvfs(const Point& _p)
         delete body_;
     }
     body_ = new Body;
-    if (!body_) {
-        std::cout << "[ERROR] mvfs: 无法创建体" << std::endl;
-        delete v;
-        return nullptr;
-    }
     // 显式初始化所有计数为0
     body_->face_num_ = 0;
     body_->edge_num_ = 0;
     body_->vertex_num_ = 0;
     
+    // 创建顶点，分配在新体的内存池中
+    Vertex* v = body_->create_vertex(_p);
+    
     // 创建面
-    Face* face = new Face;
-    if (!face) {
-        std::cout << "[ERROR] mvfs: 无法创建面" << std::endl;
-        delete v;
-        delete body_;
-        body_ = nullptr;
-        return nullptr;
-    }
+    Face* face = body_->arena_.create<Face>();
     face->body_ = body_;
     face->next_face_ = nullptr;
     face->prev_face_ = nullptr;
@@ -44,24 +33,25 @@ Vertex* EulerOperations::mvfs(const Point& _p)
     body_->face_num_ = 1;
     
     // 创建外环
-    Loop* loop = new Loop;
-    if (!loop) {
-        std::cout << "[ERROR] mvfs: 无法创建环" << std::endl;
-        delete v;
-        delete face;
-        delete body_;
-        body_ = nullptr;
-        return nullptr;
-    }
+    Loop* loop = body_->arena_.create<Loop>();
     loop->face_ = face;
     loop->next_loop_ = nullptr;
     loop->prev_loop_ = nullptr;
     face->first_loop_ = loop;
     
-    // 设置顶点数为1
-    body_->vertex_num_ = 1;
+    body_->revision_++;
+    if (recorder_) recorder_->on_mvfs(v, loop);
     
-    std::cout << "[DEBUG] mvfs操作完成，成功创建顶点" << std::endl;
+    EULER_LOG("[DEBUG] mvfs操作完成，成功创建顶点");
+    return v;
+}
+
+Vertex* EulerOperations::new_vertex(const Point& _p)
+{
+    if (!body_) return nullptr;
+    body_->revision_++;
+    Vertex* v = body_->create_vertex(_p);
+    if (recorder_) recorder_->on_vertex(v);
     return v;
 }
 
@@ -69,12 +59,18 @@ Halfedge* EulerOperations::mev(Vertex* _v0, Vertex* _v1, Loop* _loop)
 {
     if (!_v0 || !_v1 || !_loop) return nullptr;
     
-    std::cout << "mev操作开始，连接顶点..." << std::endl;
+    EULER_LOG("mev操作开始，连接顶点...");
+    
+    // 新顶点必须由 new_vertex 在本体的内存池中创建
+    if (_v1->id_ < 0) {
+        EULER_LOG("mev: 顶点未登记到体中，请使用 new_vertex 创建");
+        return nullptr;
+    }
     
     // 创建新边及其两个半边
-    Halfedge* he0 = new Halfedge;
-    Halfedge* he1 = new Halfedge;
-    Edge* edge = new Edge;
+    Halfedge* he0 = body_->arena_.create<Halfedge>();
+    Halfedge* he1 = body_->arena_.create<Halfedge>();
+    Edge* edge = body_->arena_.create<Edge>();
 
     // 设置边和半边的关系
     he0->edge_ = edge;
@@ -109,7 +105,7 @@ Halfedge* EulerOperations::mev(Vertex* _v0, Vertex* _v1, Loop* _loop)
     // 如果环为空环（没有起始半边）
     if (_loop->start_he_ == nullptr)
     {
-        std::cout << "mev: 环为空，创建新环..." << std::endl;
+        EULER_LOG("mev: 环为空，创建新环...");
         // 形成一个环
         he0->next_he_ = he1;
         he1->next_he_ = he0;
@@ -119,23 +115,12 @@ Halfedge* EulerOperations::mev(Vertex* _v0, Vertex* _v1, Loop* _loop)
     }
     else
     {
-        std::cout << "mev: 向现有环中插入边..." << std::endl;
+        EULER_LOG("mev: 向现有环中插入边...");
         // 查找以_v0为终点的半边
-        Halfedge* he = _loop->start_he_;
-        bool found = false;
-        
-        if (he) {
-            do {
-                if (he->to_vertex_ == _v0) {
-                    found = true;
-                    break;
-                }
-                he = he->next_he_;
-            } while (he != _loop->start_he_);
-        }
+        Halfedge* he = findHalfedgeTo(_loop, _v0);
     
         // 如果找到正确的半边
-        if (found && he) {
+        if (he) {
             // 插入新的半边到环中
             he0->next_he_ = he1;
             he0->prev_he_ = he;
@@ -147,18 +132,18 @@ Halfedge* EulerOperations::mev(Vertex* _v0, Vertex* _v1, Loop* _loop)
                 he->next_he_->prev_he_ = he1;
                 he->next_he_ = he0;
             } else {
-                std::cout << "mev: 环结构不完整" << std::endl;
-                delete he0;
-                delete he1;
-                delete edge;
+                EULER_LOG("mev: 环结构不完整");
+                body_->arena_.destroy(he0);
+                body_->arena_.destroy(he1);
+                body_->arena_.destroy(edge);
                 return nullptr;
             }
         } else {
-            std::cout << "mev: 未找到正确的插入位置" << std::endl;
+            EULER_LOG("mev: 未找到正确的插入位置");
             // 清理资源
-            delete he0;
-            delete he1;
-            delete edge;
+            body_->arena_.destroy(he0);
+            body_->arena_.destroy(he1);
+            body_->arena_.destroy(edge);
             return nullptr;
         }
     }
@@ -166,58 +151,80 @@ Halfedge* EulerOperations::mev(Vertex* _v0, Vertex* _v1, Loop* _loop)
     // 更新体的边信息
     body_->edges_.push_back(edge);
     body_->edge_num_++;
-    body_->vertex_num_++;
+    body_->revision_++;
+    if (recorder_) recorder_->on_mev(_v0, _v1, _loop);
 
-    std::cout << "mev: 操作完成" << std::endl;
+    EULER_LOG("mev: 操作完成");
     return he0;
 }
 
 Loop* EulerOperations::mef(Vertex* _v0, Vertex* _v1, Loop* _lp)
 {
-    if (!_v0 || !_v1 || !_lp) return nullptr;
+    if (!_v0 || !_v1 || !_lp || !_lp->start_he_) return nullptr;
     
-    std::cout << "mef操作开始..." << std::endl;
+    EULER_LOG("mef操作开始...");
     
-    // 查找连接_v0和_v1的边
-    Halfedge* he = _lp->start_he_;
-    Halfedge* target_he = nullptr;
+    // 在环中查找分别以_v0和_v1为终点的半边，新边将插在它们之后
+    Halfedge* he_to_v0 = nullptr;
+    Halfedge* he_to_v1 = nullptr;
     
-    // 遍历环查找对应的半边
-    if (he) {
-        do {
-            if (he->start_vertex_ == _v0 && he->to_vertex_ == _v1) {
-                target_he = he;
-                break;
-            }
-            he = he->next_he_;
-        } while (he != _lp->start_he_);
+    for (Halfedge* he : halfedges(_lp)) {
+        if (!he_to_v0 && he->to_vertex_ == _v0) he_to_v0 = he;
+        if (!he_to_v1 && he->to_vertex_ == _v1) he_to_v1 = he;
     }
     
-    // 如果没有找到对应的半边，先使用mev创建
-    if (target_he == nullptr) {
-        std::cout << "mef: 未找到边，调用mev创建..." << std::endl;
-        target_he = mev(_v0, _v1, _lp);
-        if (!target_he) {
-            std::cout << "mef: mev调用失败" << std::endl;
-            return nullptr;
-        }
+    if (!he_to_v0 || !he_to_v1) {
+        EULER_LOG("mef: 顶点不在环上");
+        return nullptr;
     }
     
+    // 创建新边及其两个半边：he0为_v0->_v1，留在原环；he1为_v1->_v0，属于新环
+    Halfedge* he0 = body_->arena_.create<Halfedge>();
+    Halfedge* he1 = body_->arena_.create<Halfedge>();
+    Edge* edge = body_->arena_.create<Edge>();
+    
+    he0->edge_ = edge;
+    he1->edge_ = edge;
+    edge->he0_ = he0;
+    edge->he1_ = he1;
+    
+    he0->start_vertex_ = _v0;
+    he0->to_vertex_ = _v1;
+    he1->start_vertex_ = _v1;
+    he1->to_vertex_ = _v0;
+    
+    he0->oppo_he_ = he1;
+    he1->oppo_he_ = he0;
+    
+    // 分割原环：he0接在以_v0为终点的半边之后，he1接在以_v1为终点的半边之后
+    Halfedge* next_v0 = he_to_v0->next_he_;
+    Halfedge* next_v1 = he_to_v1->next_he_;
+    
+    he_to_v0->next_he_ = he0;
+    he0->prev_he_ = he_to_v0;
+    he0->next_he_ = next_v1;
+    next_v1->prev_he_ = he0;
+    
+    he_to_v1->next_he_ = he1;
+    he1->prev_he_ = he_to_v1;
+    he1->next_he_ = next_v0;
+    next_v0->prev_he_ = he1;
+    
     // 创建新面
-    std::cout << "mef: 创建新面..." << std::endl;
-    Face* new_face = new Face;
+    EULER_LOG("mef: 创建新面...");
+    Face* new_face = body_->arena_.create<Face>();
     new_face->body_ = body_;
     new_face->next_face_ = nullptr;
     new_face->prev_face_ = nullptr;
     new_face->first_loop_ = nullptr;
     
     // 创建新环
-    std::cout << "mef: 创建新环..." << std::endl;
-    Loop* new_loop = new Loop;
+    EULER_LOG("mef: 创建新环...");
+    Loop* new_loop = body_->arena_.create<Loop>();
     new_loop->face_ = new_face;
     new_loop->next_loop_ = nullptr;
     new_loop->prev_loop_ = nullptr;
-    new_loop->start_he_ = nullptr;
+    new_loop->start_he_ = he1;
     
     // 设置新面的第一个环
     new_face->first_loop_ = new_loop;
@@ -229,32 +236,21 @@ Loop* EulerOperations::mef(Vertex* _v0, Vertex* _v1, Loop* _lp)
     }
     body_->first_face_ = new_face;
     
-    // 分割原环
-    Halfedge* he1 = target_he;
-    Halfedge* he2 = nullptr;
-    
-    if (he1 && he1->oppo_he_) {
-        he2 = he1->oppo_he_;
-    } else {
-        std::cout << "mef: 找不到对边" << std::endl;
-        delete new_face;
-        delete new_loop;
-        return nullptr;
+    // 更新两个环中半边所属的环：原环余下的半边本就属于 _lp，只需标记 he0 和新环
+    _lp->start_he_ = he0;
+    he0->loop_ = _lp;
+    for (Halfedge* he : halfedges(new_loop)) {
+        he->loop_ = new_loop;
     }
     
-    // 更新原环的起始半边
-    _lp->start_he_ = he1->next_he_;
-    
-    // 设置新环的起始半边
-    new_loop->start_he_ = he2->next_he_;
-    
-    // 更新面的环信息
-    _lp->face_->body_ = body_;
-    
-    // 更新体的面数
+    // 更新体的边信息和面数
+    body_->edges_.push_back(edge);
+    body_->edge_num_++;
     body_->face_num_++;
+    body_->revision_++;
+    if (recorder_) recorder_->on_mef(_v0, _v1, _lp, new_loop);
     
-    std::cout << "mef: 操作完成" << std::endl;
+    EULER_LOG("mef: 操作完成");
     return new_loop;
 }
 
@@ -262,61 +258,55 @@ Loop* EulerOperations::kemr(Vertex* _v0, Vertex* _v1, Loop* _lp)
 {
     if (!_v0 || !_v1 || !_lp) return nullptr;
     
-    // 查找连接_v0和_v1的边
-    Halfedge* he = _lp->start_he_;
-    Halfedge* target_he = nullptr;
-    
-    while (he) {
-        if ((he->start_vertex_ == _v0 && he->to_vertex_ == _v1) ||
-            (he->start_vertex_ == _v1 && he->to_vertex_ == _v0)) {
-            target_he = he;
-            break;
-        }
-        he = he->next_he_;
-        if (he == _lp->start_he_) break;
+    // 查找连接_v0和_v1的边，其两条半边都必须在_lp中
+    Halfedge* he_a = findEdgeHalfedge(_lp, _v0, _v1);
+    if (he_a && he_a->start_vertex_ != _v0) he_a = he_a->oppo_he_;
+    if (!he_a || !he_a->oppo_he_ || he_a->loop_ != _lp || he_a->oppo_he_->loop_ != _lp) {
+        EULER_LOG("kemr: 边的两侧不在同一个环中");
+        return nullptr;
     }
-    
-    if (!target_he) return nullptr;
-    
-    Halfedge* oppo_he = target_he->oppo_he_;
-    if (!oppo_he) return nullptr;
-    
-    Edge* edge = target_he->edge_;
-    if (!edge) return nullptr;
-    
-    // 创建内环
-    Loop* inner_loop = new Loop;
-    inner_loop->face_ = _lp->face_;
-    inner_loop->next_loop_ = nullptr;
-    inner_loop->prev_loop_ = nullptr;
-    
-    // 保存需要的半边
-    Halfedge* prev_he = target_he->prev_he_;
-    Halfedge* next_he = oppo_he->next_he_;
-    Halfedge* oppo_prev_he = oppo_he->prev_he_;
-    
-    if (!prev_he || !next_he || !oppo_prev_he) {
-        delete inner_loop;
+    Halfedge* he_b = he_a->oppo_he_;
+    Edge* edge = he_a->edge_;
+    
+    // 环的形式为 ... p -> he_a(v0->v1) -> n ... q -> he_b(v1->v0) -> m ...
+    // 删边后 p -> m 留在原环（含_v0），q -> n 组成新的内环（含_v1）
+    Halfedge* p = he_a->prev_he_;
+    Halfedge* n = he_a->next_he_;
+    Halfedge* q = he_b->prev_he_;
+    Halfedge* m = he_b->next_he_;
+    if (n == he_b || m == he_a) {
+        EULER_LOG("kemr: 删边后有一侧只剩孤立顶点");
         return nullptr;
     }
     
-    // 重新连接外环的半边
-    prev_he->next_he_ = next_he;
-    next_he->prev_he_ = prev_he;
+    p->next_he_ = m;
+    m->prev_he_ = p;
+    q->next_he_ = n;
+    n->prev_he_ = q;
+    _lp->start_he_ = m;
+    _v0->he_ = m;
+    _v1->he_ = n;
     
-    // 设置内环的起始半边
-    inner_loop->start_he_ = oppo_prev_he;
-    
-    // 插入内环到面的环列表中
+    // 创建内环并加入同一个面
+    Loop* inner_loop = body_->arena_.create<Loop>();
+    inner_loop->face_ = _lp->face_;
+    inner_loop->start_he_ = n;
+    for (Halfedge* he : halfedges(inner_loop)) {
+        he->loop_ = inner_loop;
+    }
     inner_loop->next_loop_ = _lp->face_->first_loop_;
+    inner_loop->prev_loop_ = nullptr;
     if (_lp->face_->first_loop_) {
         _lp->face_->first_loop_->prev_loop_ = inner_loop;
     }
     _lp->face_->first_loop_ = inner_loop;
     
-    // 从体的边列表中删除该边
-    body_->delete_edge(edge);
-    body_->edge_num_ = std::max(0, body_->edge_num_ - 1);
+    // 释放边及其两条半边
+    body_->arena_.destroy(he_a);
+    body_->arena_.destroy(he_b);
+    if (body_->delete_edge(edge)) body_->edge_num_--;
+    body_->revision_++;
+    if (recorder_) recorder_->on_kemr(_v0, _v1, _lp, inner_loop);
     
     return inner_loop;
 }
@@ -326,7 +316,8 @@ void EulerOperations::kfmrh(Loop* _out_loop, Loop* _loop)
     if (!_out_loop || !_loop) return;
     
     // 确保两个环属于不同的面
-    if (_out_loop->face_ == _loop->face_) return;
+    Face* dead_face = _loop->face_;
+    if (_out_loop->face_ == dead_face) return;
     
     // 将_loop从原来的面中移除
     if (_loop->prev_loop_) {
@@ -337,8 +328,8 @@ void EulerOperations::kfmrh(Loop* _out_loop, Loop* _loop)
     }
     
     // 如果_loop是原面的第一个环
-    if (_loop->face_->first_loop_ == _loop) {
-        _loop->face_->first_loop_ = _loop->next_loop_;
+    if (dead_face->first_loop_ == _loop) {
+        dead_face->first_loop_ = _loop->next_loop_;
     }
     
     // 将_loop添加为_out_loop所在面的内环
@@ -350,6 +341,27 @@ void EulerOperations::kfmrh(Loop* _out_loop, Loop* _loop)
     _loop->prev_loop_ = nullptr;
     _out_loop->face_->first_loop_ = _loop;
     
+    // 原面的其余环一并移入，然后从体的面链表中删除原面
+    while (Loop* rest = dead_face->first_loop_) {
+        dead_face->first_loop_ = rest->next_loop_;
+        rest->face_ = _out_loop->face_;
+        rest->prev_loop_ = nullptr;
+        rest->next_loop_ = _out_loop->face_->first_loop_;
+        _out_loop->face_->first_loop_->prev_loop_ = rest;
+        _out_loop->face_->first_loop_ = rest;
+    }
+    if (dead_face->prev_face_) {
+        dead_face->prev_face_->next_face_ = dead_face->next_face_;
+    } else if (body_->first_face_ == dead_face) {
+        body_->first_face_ = dead_face->next_face_;
+    }
+    if (dead_face->next_face_) {
+        dead_face->next_face_->prev_face_ = dead_face->prev_face_;
+    }
+    body_->arena_.destroy(dead_face);
+    
     // 减少体的面数
-    body_->face_num_ = std::max(0, body_->face_num_ - 1);
+    body_->face_num_--;
+    body_->revision_++;
+    if (recorder_) recorder_->on_kfmrh(_out_loop, _loop);
 }
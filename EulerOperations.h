@@ -3,6 +3,8 @@
 
 #include "SolidModel.h"
 
+class EulerScriptRecorder;
+
 
 
 class EulerOperations
@@ -22,10 +24,31 @@ public:
 	{
 		return body_;
 	}
+
+	/** Ȩ֮ɵ߸ͷ */
+	Body* release_body()
+	{
+		Body* body = body_;
+		body_ = nullptr;
+		return body;
+	}
+
+	/** ǷϢйʱӦر */
+	void set_verbose(bool _verbose)
+	{
+		verbose_ = _verbose;
+	}
+
+	/** ¼ִ֮гɹĲ nullptr ֹͣ¼¼ɵ߹ */
+	void set_recorder(EulerScriptRecorder* _recorder)
+	{
+		recorder_ = _recorder;
+	}
 public:
 	//--- ʵµŷ ---//
 
 	Vertex* mvfs(const Point & _p);
+	Vertex* new_vertex(const Point& _p);   // ڵǰڴд㣬 mev ʹ
 	Halfedge* mev(Vertex* _v0, Vertex * _v1, Loop* _lp);
 	Loop* mef(Vertex* _v0, Vertex* _v1, Loop* _lp);
 	Loop* kemr(Vertex* _v0, Vertex* _v1, Loop* _lp);
@@ -33,6 +56,8 @@ public:
 
 private:
 	Body* body_ = nullptr;
+	bool verbose_ = true;
+	EulerScriptRecorder* recorder_ = nullptr;
 };
 
 
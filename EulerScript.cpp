@@ -0,0 +1,456 @@
+#include "EulerScript.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "EulerOperations.h"
+
+namespace {
+
+const char BINARY_MAGIC[4] = {'E', 'U', 'L', 'B'};
+const uint32_t SCRIPT_VERSION = 1;
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+std::string atOp(size_t index, const char* message) {
+    std::ostringstream os;
+    os << "第 " << index << " 个操作: " << message;
+    return os.str();
+}
+
+// 各操作创建的记录数：{顶点, 边, 面, 环}
+void countCreated(const EulerOp& op, uint32_t counts[4]) {
+    switch (op.code) {
+    case EULER_MVFS:   counts[0]++; counts[2]++; counts[3]++; break;
+    case EULER_VERTEX: counts[0]++; break;
+    case EULER_MEV:    counts[1]++; break;
+    case EULER_MEF:    counts[1]++; counts[2]++; counts[3]++; break;
+    case EULER_KEMR:   counts[3]++; break;
+    case EULER_KFMRH:  break;
+    }
+}
+
+bool readFile(const std::string& path, std::string& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    in.seekg(0, std::ios::beg);
+    data.resize((size_t)std::max<std::streamoff>(size, 0));
+    return size <= 0 || (bool)in.read(&data[0], size);
+}
+
+//--- 文本格式 ---//
+
+// 按行扫描的游标，跳过空白和注释
+struct TextCursor {
+    const char* p;
+    const char* end;
+    size_t line = 1;
+
+    void skipSpaces() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        if (p < end && *p == '#') {
+            while (p < end && *p != '\n') p++;
+        }
+    }
+    bool atLineEnd() {
+        skipSpaces();
+        return p >= end || *p == '\n';
+    }
+    void nextLine() {
+        while (p < end && *p != '\n') p++;
+        if (p < end) { p++; line++; }
+    }
+    bool word(std::string& out) {
+        skipSpaces();
+        const char* s = p;
+        while (p < end && ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z'))) p++;
+        out.assign(s, p);
+        return p > s;
+    }
+    // strtoul / strtod 会跳过换行，先确认本行还有内容
+    bool number(uint32_t& out) {
+        if (atLineEnd()) return false;
+        char* stop;
+        unsigned long v = std::strtoul(p, &stop, 10);
+        if (stop == p || stop > end) return false;
+        p = stop;
+        out = (uint32_t)v;
+        return true;
+    }
+    bool number(double& out) {
+        if (atLineEnd()) return false;
+        char* stop;
+        out = std::strtod(p, &stop);
+        if (stop == p || stop > end) return false;
+        p = stop;
+        return true;
+    }
+};
+
+bool parseText(const std::string& data, EulerScript& script, bool& hasHeader, std::string* error) {
+    TextCursor cur{data.c_str(), data.c_str() + data.size()};
+    std::string keyword;
+    bool seenMagic = false;
+
+    for (; cur.p < cur.end; cur.nextLine()) {
+        if (cur.atLineEnd()) continue;
+        std::ostringstream where;
+        where << "第 " << cur.line << " 行: ";
+        if (!cur.word(keyword)) return fail(error, where.str() + "应为操作名");
+
+        if (!seenMagic) {
+            uint32_t version;
+            if (keyword != "eulerscript" || !cur.number(version)) return fail(error, where.str() + "缺少 eulerscript 文件头");
+            if (version != SCRIPT_VERSION) return fail(error, where.str() + "不支持的版本");
+            seenMagic = true;
+            continue;
+        }
+
+        EulerOp op = {};
+        bool ok = true;
+        if (keyword == "header") {
+            ok = cur.number(script.vertexCount) && cur.number(script.edgeCount) &&
+                 cur.number(script.faceCount) && cur.number(script.loopCount);
+            hasHeader = true;
+            if (!ok || !cur.atLineEnd()) return fail(error, where.str() + "header 需要 4 个计数");
+            continue;
+        } else if (keyword == "mvfs" || keyword == "vertex") {
+            op.code = keyword == "mvfs" ? EULER_MVFS : EULER_VERTEX;
+            ok = cur.number(op.p[0]) && cur.number(op.p[1]) && cur.number(op.p[2]);
+        } else if (keyword == "mev" || keyword == "mef" || keyword == "kemr") {
+            op.code = keyword == "mev" ? EULER_MEV : (keyword == "mef" ? EULER_MEF : EULER_KEMR);
+            ok = cur.number(op.a) && cur.number(op.b) && cur.number(op.c);
+        } else if (keyword == "kfmrh") {
+            op.code = EULER_KFMRH;
+            ok = cur.number(op.a) && cur.number(op.b);
+        } else {
+            return fail(error, where.str() + "未知操作 " + keyword);
+        }
+        if (!ok || !cur.atLineEnd()) return fail(error, where.str() + keyword + " 的参数不正确");
+        script.ops.push_back(op);
+    }
+    if (!seenMagic) return fail(error, "缺少 eulerscript 文件头");
+    return true;
+}
+
+//--- 二进制格式 ---//
+
+template <class T>
+void put(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool get(const char*& p, const char* end, T& value) {
+    if ((size_t)(end - p) < sizeof(T)) return false;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+bool parseBinary(const std::string& data, EulerScript& script, std::string* error) {
+    const char* p = data.data() + sizeof(BINARY_MAGIC);
+    const char* end = data.data() + data.size();
+    uint32_t version, opCount;
+    if (!get(p, end, version) || !get(p, end, script.vertexCount) || !get(p, end, script.edgeCount) ||
+        !get(p, end, script.faceCount) || !get(p, end, script.loopCount) || !get(p, end, opCount)) {
+        return fail(error, "二进制文件头不完整");
+    }
+    if (version != SCRIPT_VERSION) return fail(error, "不支持的版本");
+
+    // 每个操作至少 9 字节，操作数明显超出文件大小时不预留
+    if (opCount <= (size_t)(end - p) / 9) script.ops.reserve(opCount);
+    for (uint32_t i = 0; i < opCount; i++) {
+        EulerOp op = {};
+        uint8_t code = 0;
+        if (!get(p, end, code)) return fail(error, atOp(i, "数据不完整"));
+        op.code = (EulerOpCode)code;
+        bool ok;
+        switch (code) {
+        case EULER_MVFS:
+        case EULER_VERTEX:
+            ok = get(p, end, op.p[0]) && get(p, end, op.p[1]) && get(p, end, op.p[2]);
+            break;
+        case EULER_MEV:
+        case EULER_MEF:
+        case EULER_KEMR:
+            ok = get(p, end, op.a) && get(p, end, op.b) && get(p, end, op.c);
+            break;
+        case EULER_KFMRH:
+            ok = get(p, end, op.a) && get(p, end, op.b);
+            break;
+        default:
+            return fail(error, atOp(i, "未知操作码"));
+        }
+        if (!ok) return fail(error, atOp(i, "数据不完整"));
+        script.ops.push_back(op);
+    }
+    return true;
+}
+
+bool writeFile(const std::string& path, const std::string& data, std::string* error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(data.data(), (std::streamsize)data.size())) return fail(error, "无法写入 " + path);
+    return true;
+}
+
+} // namespace
+
+bool validateEulerScript(const EulerScript& script, std::string* error) {
+    uint32_t counts[4] = {0, 0, 0, 0};
+    for (size_t i = 0; i < script.ops.size(); i++) {
+        const EulerOp& op = script.ops[i];
+        if ((i == 0) != (op.code == EULER_MVFS)) {
+            return fail(error, atOp(i, i == 0 ? "脚本必须以 mvfs 开始" : "mvfs 只能出现一次"));
+        }
+        switch (op.code) {
+        case EULER_MVFS:
+        case EULER_VERTEX:
+            break;
+        case EULER_MEV:
+        case EULER_MEF:
+        case EULER_KEMR:
+            if (op.a >= counts[0] || op.b >= counts[0]) return fail(error, atOp(i, "引用了尚未创建的顶点"));
+            if (op.c >= counts[3]) return fail(error, atOp(i, "引用了尚未创建的环"));
+            if (op.a == op.b) return fail(error, atOp(i, "两个顶点相同"));
+            break;
+        case EULER_KFMRH:
+            if (op.a >= counts[3] || op.b >= counts[3]) return fail(error, atOp(i, "引用了尚未创建的环"));
+            if (op.a == op.b) return fail(error, atOp(i, "两个环相同"));
+            break;
+        default:
+            return fail(error, atOp(i, "未知操作码"));
+        }
+        countCreated(op, counts);
+    }
+    if (script.vertexCount < counts[0] || script.edgeCount < counts[1] ||
+        script.faceCount < counts[2] || script.loopCount < counts[3]) {
+        return fail(error, "头部的计数小于脚本实际创建的记录数");
+    }
+    return true;
+}
+
+bool readEulerScript(const std::string& path, EulerScript& script, std::string* error) {
+    script.clear();
+    std::string data;
+    if (!readFile(path, data)) return fail(error, "无法读取 " + path);
+
+    bool hasHeader = false;
+    bool ok;
+    if (data.size() >= sizeof(BINARY_MAGIC) && std::memcmp(data.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+        hasHeader = true;
+        ok = parseBinary(data, script, error);
+    } else {
+        ok = parseText(data, script, hasHeader, error);
+    }
+    if (!ok) return false;
+
+    // 文本脚本省略 header 时按操作统计
+    if (!hasHeader) {
+        uint32_t counts[4] = {0, 0, 0, 0};
+        for (const EulerOp& op : script.ops) countCreated(op, counts);
+        script.vertexCount = counts[0];
+        script.edgeCount = counts[1];
+        script.faceCount = counts[2];
+        script.loopCount = counts[3];
+    }
+    return validateEulerScript(script, error);
+}
+
+bool writeEulerScriptText(const std::string& path, const EulerScript& script, std::string* error) {
+    std::string out;
+    out.reserve(script.ops.size() * 32 + 64);
+    char line[128];
+    std::snprintf(line, sizeof(line), "eulerscript %u\nheader %u %u %u %u\n", SCRIPT_VERSION,
+                  script.vertexCount, script.edgeCount, script.faceCount, script.loopCount);
+    out += line;
+    for (const EulerOp& op : script.ops) {
+        int n = 0;
+        switch (op.code) {
+        case EULER_MVFS:
+        case EULER_VERTEX:
+            // %.17g 保证坐标原样读回
+            n = std::snprintf(line, sizeof(line), "%s %.17g %.17g %.17g\n",
+                              op.code == EULER_MVFS ? "mvfs" : "vertex", op.p[0], op.p[1], op.p[2]);
+            break;
+        case EULER_MEV:
+        case EULER_MEF:
+        case EULER_KEMR:
+            n = std::snprintf(line, sizeof(line), "%s %u %u %u\n",
+                              op.code == EULER_MEV ? "mev" : (op.code == EULER_MEF ? "mef" : "kemr"), op.a, op.b, op.c);
+            break;
+        case EULER_KFMRH:
+            n = std::snprintf(line, sizeof(line), "kfmrh %u %u\n", op.a, op.b);
+            break;
+        }
+        out.append(line, (size_t)std::max(n, 0));
+    }
+    return writeFile(path, out, error);
+}
+
+bool writeEulerScriptBinary(const std::string& path, const EulerScript& script, std::string* error) {
+    std::string out;
+    out.reserve(28 + script.ops.size() * 25);
+    out.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    put(out, SCRIPT_VERSION);
+    put(out, script.vertexCount);
+    put(out, script.edgeCount);
+    put(out, script.faceCount);
+    put(out, script.loopCount);
+    put(out, (uint32_t)script.ops.size());
+    for (const EulerOp& op : script.ops) {
+        put(out, (uint8_t)op.code);
+        switch (op.code) {
+        case EULER_MVFS:
+        case EULER_VERTEX:
+            put(out, op.p[0]);
+            put(out, op.p[1]);
+            put(out, op.p[2]);
+            break;
+        case EULER_MEV:
+        case EULER_MEF:
+        case EULER_KEMR:
+            put(out, op.a);
+            put(out, op.b);
+            put(out, op.c);
+            break;
+        case EULER_KFMRH:
+            put(out, op.a);
+            put(out, op.b);
+            break;
+        }
+    }
+    return writeFile(path, out, error);
+}
+
+Body* replayEulerScript(const EulerScript& script, size_t* failedOps) {
+    return replayEulerScript(script, failedOps, ReplayProgress(), 0);
+}
+
+Body* replayEulerScript(const EulerScript& script, size_t* failedOps, const ReplayProgress& progress, size_t interval) {
+    if (failedOps) *failedOps = 0;
+    if (script.ops.empty()) return nullptr;
+
+    EulerOperations ops;
+    ops.set_verbose(false);
+    std::vector<Loop*> loops;
+    loops.reserve(script.loopCount);
+    Body* body = nullptr;
+    size_t failed = 0;
+    size_t done = 0;
+
+    for (const EulerOp& op : script.ops) {
+        switch (op.code) {
+        case EULER_MVFS:
+            ops.mvfs(Point(op.p));
+            body = ops.get_body();
+            body->reserve(script.vertexCount, script.edgeCount, script.faceCount, script.loopCount);
+            loops.push_back(body->first_face_->first_loop_);
+            break;
+        case EULER_VERTEX:
+            ops.new_vertex(Point(op.p));
+            break;
+        case EULER_MEV:
+            if (!ops.mev(body->vertices_[op.a], body->vertices_[op.b], loops[op.c])) failed++;
+            break;
+        case EULER_MEF:
+        case EULER_KEMR: {
+            // 失败时也占一个环编号，保证后续引用的编号不错位
+            Vertex* v0 = body->vertices_[op.a];
+            Vertex* v1 = body->vertices_[op.b];
+            Loop* loop = op.code == EULER_MEF ? ops.mef(v0, v1, loops[op.c]) : ops.kemr(v0, v1, loops[op.c]);
+            if (!loop) failed++;
+            loops.push_back(loop);
+            break;
+        }
+        case EULER_KFMRH:
+            ops.kfmrh(loops[op.a], loops[op.b]);
+            break;
+        }
+        // 中止时 ops 析构，释放已构建的部分
+        done++;
+        if (progress && interval > 0 && done % interval == 0 && !progress(body, done)) return nullptr;
+    }
+
+    if (progress && !progress(body, done)) return nullptr;
+    if (failedOps) *failedOps = failed;
+    return ops.release_body();
+}
+
+bool eulerScriptBounds(const EulerScript& script, double lo[3], double hi[3]) {
+    bool first = true;
+    for (const EulerOp& op : script.ops) {
+        if (op.code != EULER_MVFS && op.code != EULER_VERTEX) continue;
+        for (int k = 0; k < 3; k++) {
+            if (first || op.p[k] < lo[k]) lo[k] = op.p[k];
+            if (first || op.p[k] > hi[k]) hi[k] = op.p[k];
+        }
+        first = false;
+    }
+    return !first;
+}
+
+//--- EulerScriptRecorder ---//
+
+void EulerScriptRecorder::add_loop(const Loop* _loop) {
+    uint32_t id = script_.loopCount++;
+    if (_loop) loop_ids_[_loop] = id;
+}
+
+void EulerScriptRecorder::push(EulerOpCode _code, uint32_t _a, uint32_t _b, uint32_t _c) {
+    EulerOp op = {};
+    op.code = _code;
+    op.a = _a;
+    op.b = _b;
+    op.c = _c;
+    script_.ops.push_back(op);
+}
+
+void EulerScriptRecorder::on_mvfs(const Vertex* _v, const Loop* _loop) {
+    // mvfs 开始一个新的实体，之前的记录作废
+    script_.clear();
+    loop_ids_.clear();
+    EulerOp op = {};
+    op.code = EULER_MVFS;
+    for (int i = 0; i < 3; i++) op.p[i] = _v->p_[i];
+    script_.ops.push_back(op);
+    script_.vertexCount = 1;
+    script_.faceCount = 1;
+    add_loop(_loop);
+}
+
+void EulerScriptRecorder::on_vertex(const Vertex* _v) {
+    EulerOp op = {};
+    op.code = EULER_VERTEX;
+    for (int i = 0; i < 3; i++) op.p[i] = _v->p_[i];
+    script_.ops.push_back(op);
+    script_.vertexCount++;
+}
+
+void EulerScriptRecorder::on_mev(const Vertex* _v0, const Vertex* _v1, const Loop* _loop) {
+    push(EULER_MEV, (uint32_t)_v0->id_, (uint32_t)_v1->id_, loop_ids_[_loop]);
+    script_.edgeCount++;
+}
+
+void EulerScriptRecorder::on_mef(const Vertex* _v0, const Vertex* _v1, const Loop* _loop, const Loop* _new_loop) {
+    push(EULER_MEF, (uint32_t)_v0->id_, (uint32_t)_v1->id_, loop_ids_[_loop]);
+    script_.edgeCount++;
+    script_.faceCount++;
+    add_loop(_new_loop);
+}
+
+void EulerScriptRecorder::on_kemr(const Vertex* _v0, const Vertex* _v1, const Loop* _loop, const Loop* _new_loop) {
+    push(EULER_KEMR, (uint32_t)_v0->id_, (uint32_t)_v1->id_, loop_ids_[_loop]);
+    add_loop(_new_loop);
+}
+
+void EulerScriptRecorder::on_kfmrh(const Loop* _out_loop, const Loop* _loop) {
+    push(EULER_KFMRH, loop_ids_[_out_loop], loop_ids_[_loop], 0);
+}
@@ -0,0 +1,109 @@
+#ifndef _EULER_SCRIPT_H_
+#define _EULER_SCRIPT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SolidModel.h"
+
+// 欧拉操作脚本：把一次建模过程记录为操作序列，可保存为文本或二进制文件并重放
+// 顶点按 Vertex::id_（即创建顺序）引用；环按创建顺序引用：mvfs 的外环为 0，之后每次 mef / kemr 产生的新环依次编号
+//
+// 文本格式，每行一个操作，# 之后为注释：
+//     eulerscript 1
+//     header <顶点数> <边数> <面数> <环数>      可省略，省略时由读取函数统计
+//     mvfs x y z
+//     vertex x y z                              对应 EulerOperations::new_vertex
+//     mev v0 v1 loop
+//     mef v0 v1 loop
+//     kemr v0 v1 loop
+//     kfmrh outLoop loop
+//
+// 二进制格式（小端）：
+//     "EULB" | u32 版本 | u32 顶点数 | u32 边数 | u32 面数 | u32 环数 | u32 操作数
+//     之后每个操作为 u8 操作码，mvfs / vertex 跟 3 个 f64，mev / mef / kemr 跟 3 个 u32，kfmrh 跟 2 个 u32
+
+enum EulerOpCode : uint8_t
+{
+    EULER_MVFS = 1,
+    EULER_VERTEX = 2,
+    EULER_MEV = 3,
+    EULER_MEF = 4,
+    EULER_KEMR = 5,
+    EULER_KFMRH = 6
+};
+
+typedef struct EulerOp
+{
+    EulerOpCode code;
+    uint32_t a;      // mev / mef / kemr: v0；kfmrh: 外环
+    uint32_t b;      // mev / mef / kemr: v1；kfmrh: 内环
+    uint32_t c;      // mev / mef / kemr: 环
+    double p[3];     // mvfs / vertex 的坐标
+} EulerOp;
+
+// 头部记录构建过程中创建的记录数（kemr 删除的边也计入），重放时据此一次性预留存储
+typedef struct EulerScript
+{
+    uint32_t vertexCount = 0;
+    uint32_t edgeCount = 0;
+    uint32_t faceCount = 0;
+    uint32_t loopCount = 0;
+    std::vector<EulerOp> ops;
+
+    void clear()
+    {
+        vertexCount = edgeCount = faceCount = loopCount = 0;
+        ops.clear();
+    }
+} EulerScript;
+
+// 检查脚本：以 mvfs 开始且只有一个 mvfs，引用的顶点和环都已创建，头部的计数不小于实际创建数
+// 读取函数已做过检查；手工构造的脚本在重放前应调用一次
+bool validateEulerScript(const EulerScript& script, std::string* error);
+
+// 根据文件头自动识别文本或二进制格式，读入后校验
+bool readEulerScript(const std::string& path, EulerScript& script, std::string* error);
+bool writeEulerScriptText(const std::string& path, const EulerScript& script, std::string* error);
+bool writeEulerScriptBinary(const std::string& path, const EulerScript& script, std::string* error);
+
+// 按脚本一次性构建实体，所有权交给调用者
+// 先按头部预留顶点表、边表和内存池，再关闭调试输出连续执行全部操作；逐条操作不再检查下标，脚本须已校验
+// failedOps 不为空时返回执行失败（欧拉操作返回空）的操作数
+Body* replayEulerScript(const EulerScript& script, size_t* failedOps = nullptr);
+
+// 重放进度回调：参数为正在构建的实体和已执行的操作数，返回 false 时中止重放
+typedef std::function<bool(const Body*, size_t)> ReplayProgress;
+
+// 同上，每执行 interval 个操作（以及全部执行完后）调用一次 progress，此时实体处于两次操作之间的一致状态
+// 中止时释放已构建的部分并返回 nullptr
+Body* replayEulerScript(const EulerScript& script, size_t* failedOps, const ReplayProgress& progress, size_t interval);
+
+// mvfs / vertex 给出的所有顶点坐标的范围，不必重放即可得到模型的包围盒；脚本中没有顶点时返回 false
+bool eulerScriptBounds(const EulerScript& script, double lo[3], double hi[3]);
+
+// 记录 EulerOperations 上执行成功的操作，通过 EulerOperations::set_recorder 挂接
+class EulerScriptRecorder
+{
+public:
+    explicit EulerScriptRecorder(EulerScript& _script) : script_(_script) {}
+
+    void on_mvfs(const Vertex* _v, const Loop* _loop);
+    void on_vertex(const Vertex* _v);
+    void on_mev(const Vertex* _v0, const Vertex* _v1, const Loop* _loop);
+    void on_mef(const Vertex* _v0, const Vertex* _v1, const Loop* _loop, const Loop* _new_loop);
+    void on_kemr(const Vertex* _v0, const Vertex* _v1, const Loop* _loop, const Loop* _new_loop);
+    void on_kfmrh(const Loop* _out_loop, const Loop* _loop);
+
+private:
+    void add_loop(const Loop* _loop);
+    void push(EulerOpCode _code, uint32_t _a, uint32_t _b, uint32_t _c);
+
+    EulerScript& script_;
+    std::unordered_map<const Loop*, uint32_t> loop_ids_;
+};
+
+#endif // !_EULER_SCRIPT_H_
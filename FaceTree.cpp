@@ -0,0 +1,112 @@
+#include "FaceTree.h"
+#include <algorithm>
+#include <numeric>
+#include "Topology.h"
+
+namespace {
+
+const size_t LEAF_SIZE = 4;
+
+} // namespace
+
+void AABB::expand(const Point& p) {
+    for (int k = 0; k < 3; k++) {
+        if (empty || p[k] < min[k]) min[k] = p[k];
+        if (empty || p[k] > max[k]) max[k] = p[k];
+    }
+    empty = false;
+}
+
+void AABB::merge(const AABB& other) {
+    if (other.empty) return;
+    expand(Point(other.min));
+    expand(Point(other.max));
+}
+
+bool AABB::overlaps(const AABB& other) const {
+    if (empty || other.empty) return false;
+    for (int k = 0; k < 3; k++) {
+        if (max[k] < other.min[k] || other.max[k] < min[k]) return false;
+    }
+    return true;
+}
+
+AABB FaceTree::face_box(const Face* _face) {
+    AABB box;
+    for (const Loop* loop : loops(_face)) {
+        for (const Vertex* v : loopVertices(loop)) box.expand(v->p_);
+    }
+    return box;
+}
+
+void FaceTree::build(const Body* _body) {
+    clear();
+    for (Face* face : faces(_body)) {
+        faces_.push_back(face);
+        boxes_.push_back(face_box(face));
+    }
+    rebuild();
+}
+
+void FaceTree::insert(Face* _face) {
+    faces_.push_back(_face);
+    boxes_.push_back(face_box(_face));
+    if (faces_.size() - built_ > std::max<size_t>(64, built_ / 8)) rebuild();
+}
+
+void FaceTree::clear() {
+    nodes_.clear();
+    faces_.clear();
+    boxes_.clear();
+    built_ = 0;
+}
+
+void FaceTree::rebuild() {
+    nodes_.clear();
+    built_ = faces_.size();
+    if (faces_.empty()) return;
+    nodes_.reserve(2 * faces_.size() / LEAF_SIZE + 1);
+    build_node(0, faces_.size());
+}
+
+int FaceTree::build_node(size_t _begin, size_t _end) {
+    int index = (int)nodes_.size();
+    nodes_.emplace_back();
+    AABB box, centers;
+    for (size_t i = _begin; i < _end; i++) {
+        box.merge(boxes_[i]);
+        double c[3];
+        for (int k = 0; k < 3; k++) c[k] = 0.5 * (boxes_[i].min[k] + boxes_[i].max[k]);
+        centers.expand(Point(c));
+    }
+    nodes_[index].box_ = box;
+    nodes_[index].begin_ = _begin;
+    nodes_[index].end_ = _end;
+    if (_end - _begin <= LEAF_SIZE) return index;
+
+    // 沿中心分布最长的轴按中位数二分，面与包围盒一起重排
+    int axis = 0;
+    for (int k = 1; k < 3; k++) {
+        if (centers.max[k] - centers.min[k] > centers.max[axis] - centers.min[axis]) axis = k;
+    }
+    size_t mid = _begin + (_end - _begin) / 2;
+    std::vector<size_t> order(_end - _begin);
+    std::iota(order.begin(), order.end(), _begin);
+    std::nth_element(order.begin(), order.begin() + (mid - _begin), order.end(), [&](size_t a, size_t b) {
+        return boxes_[a].min[axis] + boxes_[a].max[axis] < boxes_[b].min[axis] + boxes_[b].max[axis];
+    });
+    std::vector<Face*> faces(order.size());
+    std::vector<AABB> boxes(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        faces[i] = faces_[order[i]];
+        boxes[i] = boxes_[order[i]];
+    }
+    std::copy(faces.begin(), faces.end(), faces_.begin() + _begin);
+    std::copy(boxes.begin(), boxes.end(), boxes_.begin() + _begin);
+
+    int left = build_node(_begin, mid);
+    int right = build_node(mid, _end);
+    nodes_[index].left_ = left;
+    nodes_[index].right_ = right;
+    return index;
+}
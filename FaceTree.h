@@ -0,0 +1,88 @@
+#ifndef _FACE_TREE_H_
+#define _FACE_TREE_H_
+
+#include <cstddef>
+#include <vector>
+#include "SolidModel.h"
+
+// 双精度轴对齐包围盒，坐标与 Vertex::p_ 一致，便于做保守的剔除
+typedef struct AABB
+{
+    double min[3] = {0, 0, 0};
+    double max[3] = {0, 0, 0};
+    bool empty = true;
+
+    void expand(const Point& p);
+    void merge(const AABB& other);
+    bool overlaps(const AABB& other) const;
+} AABB;
+
+// 面的包围盒层次树，用于在求交前剔除不可能相交的面对
+// 叶子中的面按包围盒中心沿最长轴二分；新加入的面先放在待合并列表中，数量超过树规模的 1/8 时整体重建，
+// 因此逐个加入面的均摊代价为对数级。树不跟踪面的删除和几何变化，这类修改之后需调用 build 重建。
+class FaceTree
+{
+public:
+    void build(const Body* _body);
+    void insert(Face* _face);
+    void clear();
+
+    size_t size() const { return faces_.size(); }
+
+    static AABB face_box(const Face* _face);
+
+    // 对包围盒满足 _test(const AABB&) 的每个面调用 _fn(Face*)，_test 对内部节点同样适用
+    template <class Test, class Fn>
+    void query(Test _test, Fn _fn) const
+    {
+        if (!nodes_.empty()) query_node(0, _test, _fn);
+        for (size_t i = built_; i < faces_.size(); i++)
+        {
+            if (_test(boxes_[i])) _fn(faces_[i]);
+        }
+    }
+
+    // 包围盒与 _box 相交的面
+    template <class Fn>
+    void query_box(const AABB& _box, Fn _fn) const
+    {
+        query([&_box](const AABB& _b) { return _b.overlaps(_box); }, _fn);
+    }
+
+private:
+    struct Node
+    {
+        AABB box_;
+        int left_ = -1;        // 叶子为 -1
+        int right_ = -1;
+        size_t begin_ = 0;     // 叶子包含 faces_[begin_, end_)
+        size_t end_ = 0;
+    };
+
+    void rebuild();
+    int build_node(size_t _begin, size_t _end);
+
+    template <class Test, class Fn>
+    void query_node(int _node, Test& _test, Fn& _fn) const
+    {
+        const Node& node = nodes_[_node];
+        if (!_test(node.box_)) return;
+        if (node.left_ < 0)
+        {
+            for (size_t i = node.begin_; i < node.end_; i++)
+            {
+                if (_test(boxes_[i])) _fn(faces_[i]);
+            }
+            return;
+        }
+        query_node(node.left_, _test, _fn);
+        query_node(node.right_, _test, _fn);
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<Face*> faces_;   // [0, built_) 按树的叶子排列，其余为待合并的新面
+    std::vector<AABB> boxes_;
+    size_t built_ = 0;
+};
+
+#endif // !_FACE_TREE_H_
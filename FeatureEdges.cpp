@@ -0,0 +1,133 @@
+#include "FeatureEdges.h"
+#include <cmath>
+#include <unordered_map>
+#include "Tessellation.h"
+#include "Topology.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEATURE_EDGES_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+void FeatureEdges::build(const Body* _body, float _feature_angle_degrees) {
+    nx_.clear();
+    ny_.clear();
+    nz_.clear();
+    face0_.clear();
+    face1_.clear();
+    feature_.clear();
+    face_count_ = 0;
+    if (!_body) return;
+
+    // 面编号与法向；有向体积为负（环整体朝内）时法向取反，保证“朝向观察者”的含义统一
+    std::unordered_map<const Face*, uint32_t> index;
+    double volume6 = 0;
+    for (const Face* face : faces(_body)) {
+        index[face] = (uint32_t)face_count_++;
+        Point3D n = faceNormal(face);
+        nx_.push_back(n.x);
+        ny_.push_back(n.y);
+        nz_.push_back(n.z);
+        for (const Loop* loop : loops(face)) {
+            if (!loop->start_he_) continue;
+            Point3D ln = loopNormal(loop);
+            const Point& p = loop->start_he_->start_vertex_->p_;
+            volume6 += ln.x * p[0] + ln.y * p[1] + ln.z * p[2];
+        }
+    }
+    if (volume6 < 0) {
+        for (size_t i = 0; i < face_count_; i++) {
+            nx_[i] = -nx_[i];
+            ny_[i] = -ny_[i];
+            nz_[i] = -nz_[i];
+        }
+    }
+    // 补齐的面法向为零，永远判为背向，不会被任何边引用
+    size_t padded = (face_count_ + 3) & ~(size_t)3;
+    nx_.resize(padded, 0.0f);
+    ny_.resize(padded, 0.0f);
+    nz_.resize(padded, 0.0f);
+    front_.assign(padded, 0);
+
+    auto faceOf = [&index](const Halfedge* _he) -> uint32_t {
+        if (!_he->loop_) return 0;
+        auto it = index.find(_he->loop_->face_);
+        return it != index.end() ? it->second : 0;
+    };
+    face0_.reserve(_body->edges_.size());
+    face1_.reserve(_body->edges_.size());
+    for (const Edge* e : _body->edges_) {
+        if (!isDrawableEdge(e)) continue;
+        face0_.push_back(faceOf(e->he0_));
+        face1_.push_back(faceOf(e->he1_));
+    }
+    set_feature_angle(_feature_angle_degrees);
+}
+
+void FeatureEdges::set_feature_angle(float _degrees) {
+    feature_angle_ = _degrees;
+    const float limit = std::cos(_degrees * 3.14159265358979f / 180.0f);
+    size_t n = face0_.size();
+    feature_.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t a = face0_[i], b = face1_[i];
+        float d = nx_[a] * nx_[b] + ny_[a] * ny_[b] + nz_[a] * nz_[b];
+        // 两侧为同一个面的边（如桥边）不是特征边
+        feature_[i] = (uint8_t)(a != b && d < limit);
+    }
+}
+
+size_t FeatureEdges::feature_count() const {
+    size_t count = 0;
+    for (uint8_t f : feature_) count += f;
+    return count;
+}
+
+void FeatureEdges::select(const ViewParams& _view, std::vector<uint32_t>& _edges) {
+    // 视空间中观察者位于 +z 方向；把视空间的 z 轴按 projectPoint 的旋转逆变换回模型空间，得到视线方向
+    const float cx = std::cos(_view.rotationX), sx = std::sin(_view.rotationX);
+    const float cy = std::cos(_view.rotationY), sy = std::sin(_view.rotationY);
+    const float dx = -sy, dy = sx * cy, dz = cx * cy;
+
+#ifdef FEATURE_EDGES_USE_SSE2
+    const __m128 vx = _mm_set1_ps(dx), vy = _mm_set1_ps(dy), vz = _mm_set1_ps(dz);
+    const __m128 zero = _mm_setzero_ps();
+
+    // 每次判断4个面
+    for (size_t i = 0; i < front_.size(); i += 4) {
+        __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&nx_[i]), vx),
+                                         _mm_mul_ps(_mm_loadu_ps(&ny_[i]), vy)),
+                              _mm_mul_ps(_mm_loadu_ps(&nz_[i]), vz));
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(d, zero));
+        front_[i] = (uint8_t)(mask & 1);
+        front_[i + 1] = (uint8_t)((mask >> 1) & 1);
+        front_[i + 2] = (uint8_t)((mask >> 2) & 1);
+        front_[i + 3] = (uint8_t)((mask >> 3) & 1);
+    }
+#else
+    for (size_t i = 0; i < front_.size(); i += 4) {
+        for (size_t k = i; k < i + 4; k++) {
+            front_[k] = (uint8_t)(nx_[k] * dx + ny_[k] * dy + nz_[k] * dz > 0);
+        }
+    }
+#endif
+
+    // 无分支地压缩：每条边都写入下一个位置，只有需要保留时才前移
+    size_t n = face0_.size();
+    _edges.resize(n + 1);
+    uint32_t* out = _edges.data();
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t a = front_[face0_[i]], b = front_[face1_[i]];
+        uint8_t keep = (uint8_t)((a ^ b) | (feature_[i] & (a | b)));
+        out[count] = (uint32_t)i;
+        count += keep;
+    }
+    _edges.resize(count);
+}
+
+size_t FeatureEdges::memory_bytes() const {
+    return (nx_.capacity() + ny_.capacity() + nz_.capacity()) * sizeof(float) +
+           (face0_.capacity() + face1_.capacity()) * sizeof(uint32_t) +
+           feature_.capacity() + front_.capacity();
+}
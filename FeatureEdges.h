@@ -0,0 +1,50 @@
+#ifndef _FEATURE_EDGES_H_
+#define _FEATURE_EDGES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Rendering.h"
+#include "SolidModel.h"
+
+/** 可绘制的边：两条半边及其端点都存在。VisualBody 与 FeatureEdges 按同一规则筛选，边的下标一致 */
+inline bool isDrawableEdge(const Edge* _e)
+{
+    return _e && _e->he0_ && _e->he1_ && _e->he0_->start_vertex_ && _e->he0_->to_vertex_;
+}
+
+// 逐帧提取轮廓边与特征边
+// 轮廓边：两侧的面一个朝向观察者、一个背向观察者；特征边：两侧面法向的夹角超过阈值。
+// 面法向和每条边两侧面的下标（由两条互为对边的半边所在的环得到）在 build 时缓存；特征标记只与几何有关，
+// 阈值改变时才重算。投影为正交投影，面是否朝向观察者只取决于法向与视线方向的点积，
+// 每帧先用SSE2一次判断4个面（不支持SSE2时逐个判断），再对边数组做一遍无分支的筛选。
+class FeatureEdges
+{
+public:
+    // 从实体建立缓存，边的顺序与 body->edges_ 中可绘制的边一致
+    void build(const Body* _body, float _feature_angle_degrees = 30.0f);
+
+    // 修改特征边的二面角阈值（度）
+    void set_feature_angle(float _degrees);
+    float feature_angle() const { return feature_angle_; }
+
+    // 选出当前视图下需要绘制的边：轮廓边，以及至少一侧面朝向观察者的特征边；结果为边下标，按升序排列
+    void select(const ViewParams& _view, std::vector<uint32_t>& _edges);
+
+    size_t edge_count() const { return face0_.size(); }
+    size_t face_count() const { return face_count_; }
+    size_t feature_count() const;
+
+    /** 缓存占用的字节数 */
+    size_t memory_bytes() const;
+
+private:
+    size_t face_count_ = 0;
+    float feature_angle_ = 30.0f;
+    std::vector<float> nx_, ny_, nz_;        // 单位面法向（SoA，长度补齐到4的倍数），整体朝外
+    std::vector<uint32_t> face0_, face1_;    // 每条边两侧面的下标
+    std::vector<uint8_t> feature_;           // 每条边是否为特征边
+    std::vector<uint8_t> front_;             // 每帧：每个面是否朝向观察者
+};
+
+#endif // !_FEATURE_EDGES_H_
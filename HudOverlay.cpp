@@ -0,0 +1,64 @@
+#include "HudOverlay.h"
+#include <algorithm>
+#include <cmath>
+
+void HudOverlay::set_lines(const std::vector<std::wstring>& _lines) {
+    if (_lines == lines_) return;
+    lines_ = _lines;
+    dirty_ = true;
+}
+
+void HudOverlay::draw(Gdiplus::Graphics& _target, int _x, int _y) {
+    if (lines_.empty()) return;
+    if (dirty_) {
+        rasterize(_target);
+    } else if (!cached_ && bitmap_) {
+        cached_.reset(new Gdiplus::CachedBitmap(bitmap_.get(), &_target));
+    }
+    if (cached_) _target.DrawCachedBitmap(cached_.get(), _x, _y);
+}
+
+void HudOverlay::rasterize(Gdiplus::Graphics& _target) {
+    if (!font_) {
+        font_.reset(new Gdiplus::Font(L"Arial", 12));
+        brush_.reset(new Gdiplus::SolidBrush(Gdiplus::Color(255, 255, 255)));  // 白色文字
+        format_.reset(new Gdiplus::StringFormat());
+        format_->SetAlignment(Gdiplus::StringAlignmentNear);  // 左对齐
+    }
+
+    // 先量出所有行的外框，位图只覆盖文字所在的区域
+    float right = 0, bottom = 0;
+    for (size_t i = 0; i < lines_.size(); i++) {
+        Gdiplus::RectF box;
+        _target.MeasureString(lines_[i].c_str(), -1, font_.get(), Gdiplus::PointF(0, (float)(LINE_HEIGHT * i)),
+                              format_.get(), &box);
+        right = std::max(right, box.X + box.Width);
+        bottom = std::max(bottom, box.Y + box.Height);
+    }
+    width_ = std::max(1, (int)std::ceil(right));
+    height_ = std::max(1, (int)std::ceil(bottom));
+
+    // 透明背景上不能使用ClearType（子像素颜色依赖背景），改用灰度抗锯齿
+    bitmap_.reset(new Gdiplus::Bitmap(width_, height_, PixelFormat32bppPARGB));
+    {
+        Gdiplus::Graphics graphics(bitmap_.get());
+        graphics.Clear(Gdiplus::Color(0, 0, 0, 0));
+        graphics.SetTextRenderingHint(Gdiplus::TextRenderingHintAntiAliasGridFit);
+        for (size_t i = 0; i < lines_.size(); i++) {
+            graphics.DrawString(lines_[i].c_str(), -1, font_.get(), Gdiplus::PointF(0, (float)(LINE_HEIGHT * i)),
+                                format_.get(), brush_.get());
+        }
+    }
+    cached_.reset(new Gdiplus::CachedBitmap(bitmap_.get(), &_target));
+    dirty_ = false;
+    rasterize_count_++;
+}
+
+void HudOverlay::release() {
+    cached_.reset();
+    bitmap_.reset();
+    format_.reset();
+    brush_.reset();
+    font_.reset();
+    dirty_ = true;
+}
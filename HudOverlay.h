@@ -0,0 +1,58 @@
+#ifndef _HUD_OVERLAY_H_
+#define _HUD_OVERLAY_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <windows.h>
+#include <gdiplus.h>
+
+// 叠加在模型上的提示文字层
+// 文字只在内容改变或目标设备改变（双缓冲位图重建）时用GDI+排版、光栅化一次，结果保存为带透明通道的位图，
+// 并转换为与目标设备格式一致的 CachedBitmap；每帧只做一次 DrawCachedBitmap 合成，不再逐行排版文字。
+// 字体、画刷和排版格式在第一次光栅化时创建后一直复用。所有GDI+对象须在 GdiplusShutdown 之前 release。
+class HudOverlay
+{
+public:
+    HudOverlay() = default;
+    HudOverlay(const HudOverlay&) = delete;
+    HudOverlay& operator=(const HudOverlay&) = delete;
+
+    // 设置各行文字，与当前内容相同时不做任何事
+    void set_lines(const std::vector<std::wstring>& _lines);
+
+    // 目标设备改变（如窗口大小改变后重建了双缓冲位图），下次绘制时重新生成 CachedBitmap
+    void invalidate_device() { cached_.reset(); }
+
+    // 把文字层合成到 _target 的 (_x, _y) 处，需要时先重新光栅化
+    void draw(Gdiplus::Graphics& _target, int _x, int _y);
+
+    // 文字层占用的屏幕区域（相对于绘制位置），尚未光栅化时为空
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // 累计光栅化次数，用于确认每帧没有重新排版
+    unsigned rasterize_count() const { return rasterize_count_; }
+
+    // 释放所有GDI+对象
+    void release();
+
+private:
+    void rasterize(Gdiplus::Graphics& _target);
+
+    static const int LINE_HEIGHT = 20;
+
+    std::vector<std::wstring> lines_;
+    bool dirty_ = true;                               // 文字内容改变，需要重新排版
+    int width_ = 0;
+    int height_ = 0;
+    unsigned rasterize_count_ = 0;
+
+    std::unique_ptr<Gdiplus::Font> font_;
+    std::unique_ptr<Gdiplus::SolidBrush> brush_;
+    std::unique_ptr<Gdiplus::StringFormat> format_;
+    std::unique_ptr<Gdiplus::Bitmap> bitmap_;         // 光栅化后的文字（预乘透明通道）
+    std::unique_ptr<Gdiplus::CachedBitmap> cached_;   // 按目标设备格式转换后的文字层
+};
+
+#endif // !_HUD_OVERLAY_H_
@@ -0,0 +1,93 @@
+#include "MemoryReport.h"
+#include <cstdio>
+#include "Topology.h"
+
+namespace {
+
+template <class T>
+inline void count(RecordUsage& usage) {
+    usage.count++;
+    usage.bytes += BodyArena::record_bytes(sizeof(T));
+}
+
+void printRow(std::ostream& out, const char* name, size_t count, size_t bytes) {
+    char line[96];
+    if (count > 0) {
+        std::snprintf(line, sizeof(line), "  %-16s %10zu %14zu\n", name, count, bytes);
+    } else {
+        std::snprintf(line, sizeof(line), "  %-16s %10s %14zu\n", name, "", bytes);
+    }
+    out << line;
+}
+
+} // namespace
+
+BodyMemoryReport measureBody(const Body* body) {
+    BodyMemoryReport report;
+    if (!body) return report;
+
+    for (const Vertex* v : body->vertices_) {
+        if (v) count<Vertex>(report.vertices);
+    }
+    for (const Edge* e : body->edges_) {
+        if (e) count<Edge>(report.edges);
+    }
+    for (const Face* face : faces(body)) {
+        count<Face>(report.faces);
+        for (const Loop* loop : loops(face)) {
+            count<Loop>(report.loops);
+            for (const Halfedge* he : halfedges(loop)) {
+                (void)he;
+                count<Halfedge>(report.halfedges);
+            }
+        }
+    }
+
+    report.bodyBytes = sizeof(Body);
+    report.vertexTableBytes = body->vertices_.capacity() * sizeof(Vertex*);
+    report.edgeTableBytes = body->edges_.capacity() * sizeof(Edge*);
+
+    report.arenaReserved = body->arena_.bytes_reserved();
+    report.arenaLive = body->arena_.bytes_live();
+    report.arenaPeak = body->arena_.bytes_peak();
+    report.arenaLiveRecords = body->arena_.records_live();
+
+    size_t reachable = report.vertices.count + report.halfedges.count + report.edges.count +
+                       report.loops.count + report.faces.count;
+    report.leakedRecords = report.arenaLiveRecords > reachable ? report.arenaLiveRecords - reachable : 0;
+    report.leakedBytes = report.arenaLive > report.recordBytes() ? report.arenaLive - report.recordBytes() : 0;
+
+    report.vertexCounter = body->vertex_num_;
+    report.edgeCounter = body->edge_num_;
+    report.faceCounter = body->face_num_;
+    return report;
+}
+
+void printMemoryReport(std::ostream& out, const BodyMemoryReport& body, const std::vector<BufferUsage>& buffers) {
+    out << "内存占用（字节）:\n";
+    printRow(out, "vertex", body.vertices.count, body.vertices.bytes);
+    printRow(out, "halfedge", body.halfedges.count, body.halfedges.bytes);
+    printRow(out, "edge", body.edges.count, body.edges.bytes);
+    printRow(out, "loop", body.loops.count, body.loops.bytes);
+    printRow(out, "face", body.faces.count, body.faces.bytes);
+    printRow(out, "vertices_", 0, body.vertexTableBytes);
+    printRow(out, "edges_", 0, body.edgeTableBytes);
+    printRow(out, "arena reserved", 0, body.arenaReserved);
+    printRow(out, "arena peak", 0, body.arenaPeak);
+    printRow(out, "body total", 0, body.totalBytes());
+
+    size_t bufferTotal = 0;
+    for (const BufferUsage& buffer : buffers) {
+        printRow(out, buffer.name.c_str(), 0, buffer.bytes);
+        bufferTotal += buffer.bytes;
+    }
+    if (!buffers.empty()) printRow(out, "buffers total", 0, bufferTotal);
+
+    if (body.leakedRecords > 0 || body.leakedBytes > 0) {
+        out << "  警告: " << body.leakedRecords << " 个记录（" << body.leakedBytes << " 字节）已分配但无法从实体到达\n";
+    }
+    if (!body.countersMatch()) {
+        out << "  警告: 计数器与实际不符 vertex_num_=" << body.vertexCounter << " edge_num_=" << body.edgeCounter
+            << " face_num_=" << body.faceCounter << "\n";
+    }
+}
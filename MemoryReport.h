@@ -0,0 +1,76 @@
+#ifndef _MEMORY_REPORT_H_
+#define _MEMORY_REPORT_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "SolidModel.h"
+
+// 实体与渲染缓冲的内存占用统计
+// 记录的个数和字节数通过遍历拓扑得到，与内存池中存活记录的统计对比即可发现泄漏：
+// 已分配、未释放却无法从体到达的记录（例如删边时忘记释放的半边）。
+
+// 一类记录的个数与字节数（按内存池中的实际占用计）
+typedef struct RecordUsage
+{
+    size_t count = 0;
+    size_t bytes = 0;
+} RecordUsage;
+
+typedef struct BodyMemoryReport
+{
+    // 从体可达的记录：顶点取自 vertices_，边取自 edges_，面、环、半边沿面链表遍历
+    RecordUsage vertices;
+    RecordUsage halfedges;
+    RecordUsage edges;
+    RecordUsage loops;
+    RecordUsage faces;
+
+    size_t bodyBytes = 0;          // Body 对象本身
+    size_t vertexTableBytes = 0;   // vertices_ 已分配的容量
+    size_t edgeTableBytes = 0;     // edges_ 已分配的容量
+
+    size_t arenaReserved = 0;      // 内存池向系统申请的字节数
+    size_t arenaLive = 0;          // 内存池中存活记录的字节数
+    size_t arenaPeak = 0;          // 构建过程中存活记录字节数的峰值
+    size_t arenaLiveRecords = 0;
+
+    size_t leakedRecords = 0;      // 存活但不可达的记录
+    size_t leakedBytes = 0;
+
+    // Body 中维护的计数器，与实际遍历结果不符说明某个操作没有正确维护
+    int vertexCounter = 0;
+    int edgeCounter = 0;
+    int faceCounter = 0;
+
+    bool countersMatch() const
+    {
+        return (size_t)vertexCounter == vertices.count && (size_t)edgeCounter == edges.count &&
+               (size_t)faceCounter == faces.count;
+    }
+    size_t recordBytes() const
+    {
+        return vertices.bytes + halfedges.bytes + edges.bytes + loops.bytes + faces.bytes;
+    }
+    /** 实体占用的全部内存：Body 对象、两个表和内存池申请的所有块 */
+    size_t totalBytes() const
+    {
+        return bodyBytes + vertexTableBytes + edgeTableBytes + arenaReserved;
+    }
+} BodyMemoryReport;
+
+// 一个渲染缓冲的名称与已分配字节数
+typedef struct BufferUsage
+{
+    std::string name;
+    size_t bytes = 0;
+} BufferUsage;
+
+// 统计实体的内存占用，只读实体
+BodyMemoryReport measureBody(const Body* body);
+
+// 以表格形式输出实体和各渲染缓冲的占用，发现泄漏或计数器不符时附加警告
+void printMemoryReport(std::ostream& out, const BodyMemoryReport& body, const std::vector<BufferUsage>& buffers);
+
+#endif // !_MEMORY_REPORT_H_
@@ -0,0 +1,282 @@
+#include "ModelExport.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include "ParallelFaces.h"
+#include "Topology.h"
+
+namespace {
+
+const size_t VERTEX_BLOCK = 1 << 16;     // 每块的顶点数
+const size_t FACE_BLOCK = 1 << 14;       // 每块的面数
+const size_t TRIANGLE_BLOCK = 1 << 16;   // STL 每块的三角形数
+const size_t STL_RECORD = 50;            // 法向 + 三个顶点 + 2 字节属性
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+// 可增长的输出缓冲：先取足够的空间直接写入字符，再提交实际长度
+class BlockBuffer
+{
+public:
+    explicit BlockBuffer(std::string& _out) : out_(_out), length_(0) { out_.resize(out_.capacity()); }
+    ~BlockBuffer() { out_.resize(length_); }
+
+    char* room(size_t _bytes)
+    {
+        if (length_ + _bytes > out_.size()) out_.resize(std::max(out_.size() * 2, length_ + _bytes));
+        return &out_[length_];
+    }
+    void commit(char* _end) { length_ = (size_t)(_end - out_.data()); }
+
+private:
+    std::string& out_;
+    size_t length_;
+};
+
+// 按块顺序写入文件：线程池格式化下一批块的同时，调用线程写出当前一批
+bool writeBlocks(std::FILE* file, ThreadPool& pool, size_t blockCount,
+                 const std::function<void(size_t, std::string&)>& fill) {
+    size_t wave = std::max<size_t>(pool.size() * 2, 1);
+    std::vector<std::string> current(wave), next(wave);
+
+    auto format = [&](size_t first, std::vector<std::string>& buffers) {
+        for (size_t b = first; b < std::min(first + wave, blockCount); b++) {
+            std::string* buffer = &buffers[b - first];
+            pool.submit([&fill, b, buffer] { fill(b, *buffer); });
+        }
+    };
+
+    format(0, current);
+    pool.wait();
+    bool ok = true;
+    for (size_t first = 0; first < blockCount; first += wave) {
+        if (first + wave < blockCount) format(first + wave, next);
+        for (size_t b = first; b < std::min(first + wave, blockCount) && ok; b++) {
+            const std::string& data = current[b - first];
+            ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+        }
+        pool.wait();
+        if (!ok) return false;
+        current.swap(next);
+    }
+    return true;
+}
+
+// 逐面决定输出方式，由 OBJ / PLY 共用
+struct FaceLayout {
+    FaceChunks chunks;
+    std::vector<Point3D> normals;          // 未使用时为空
+    std::vector<uint32_t> firstTriangle;   // 第 i 个面的三角形为 [firstTriangle[i], firstTriangle[i + 1])
+    std::vector<uint8_t> polygon;          // 1: 按外环输出为一个多边形；0: 输出该面的三角形
+    size_t outputFaces = 0;
+    bool flipped = false;                  // 三角化时为使法向朝外翻转了绕向，多边形也需反向
+
+    FaceLayout(const Body* body, const TriangleMesh& mesh, ThreadPool& pool, size_t maxPolygon)
+        : chunks(body, FACE_BLOCK) {
+        size_t faceCount = chunks.face_count();
+        firstTriangle.assign(faceCount + 1, 0);
+        for (uint32_t f : mesh.triangleFaces) firstTriangle[f + 1]++;
+        for (size_t i = 0; i < faceCount; i++) firstTriangle[i + 1] += firstTriangle[i];
+
+        // 只有一个环、且三角化得到 n-2 个三角形（即为简单多边形）的面直接输出外环
+        polygon.assign(faceCount, 0);
+        parallelForFaces(pool, chunks, [&](size_t i, Face* face, unsigned) {
+            if (face->first_loop_ && !face->first_loop_->next_loop_) {
+                size_t n = (size_t)loopLength(face->first_loop_);
+                polygon[i] = n >= 3 && n <= maxPolygon && firstTriangle[i + 1] - firstTriangle[i] == n - 2;
+            }
+        });
+        for (size_t i = 0; i < faceCount; i++) {
+            outputFaces += polygon[i] ? 1 : firstTriangle[i + 1] - firstTriangle[i];
+        }
+
+        for (size_t i = 0; i < faceCount && i < mesh.faceNormals.size(); i++) {
+            Point3D a = mesh.faceNormals[i];
+            Point3D b = faceNormal(chunks.faces()[i]);
+            float dot = a.x * b.x + a.y * b.y + a.z * b.z;
+            if (dot != 0) {
+                flipped = dot < 0;
+                break;
+            }
+        }
+    }
+
+    // 依次给出面 i 要输出的每个多边形的顶点下标
+    template <class Emit>
+    void forEachPolygon(size_t i, const TriangleMesh& mesh, std::vector<uint32_t>& scratch, Emit emit) const {
+        if (polygon[i]) {
+            scratch.clear();
+            for (const Vertex* v : loopVertices(chunks.faces()[i]->first_loop_)) scratch.push_back((uint32_t)v->id_);
+            if (flipped) std::reverse(scratch.begin(), scratch.end());
+            emit(scratch.data(), scratch.size());
+            return;
+        }
+        for (uint32_t t = firstTriangle[i]; t < firstTriangle[i + 1]; t++) {
+            emit(&mesh.indices[t * 3], 3);
+        }
+    }
+};
+
+//--- OBJ ---//
+
+bool exportObj(std::FILE* file, const Body* body, const TriangleMesh& mesh, ThreadPool& pool) {
+    FaceLayout layout(body, mesh, pool, (size_t)-1);
+    const std::vector<Vertex*>& vertices = body->vertices_;
+
+    char header[128];
+    int n = std::snprintf(header, sizeof(header), "# HW3 export\n# %zu vertices, %zu faces\n",
+                          vertices.size(), layout.outputFaces);
+    if (std::fwrite(header, 1, (size_t)n, file) != (size_t)n) return false;
+
+    size_t vertexBlocks = (vertices.size() + VERTEX_BLOCK - 1) / VERTEX_BLOCK;
+    bool ok = writeBlocks(file, pool, vertexBlocks, [&](size_t block, std::string& out) {
+        BlockBuffer buffer(out);
+        size_t end = std::min(vertices.size(), (block + 1) * VERTEX_BLOCK);
+        for (size_t i = block * VERTEX_BLOCK; i < end; i++) {
+            // 每个 double 的最短表示不超过 24 个字符
+            char* p = buffer.room(2 + 3 * 25 + 1);
+            *p++ = 'v';
+            for (int k = 0; k < 3; k++) {
+                *p++ = ' ';
+                p = std::to_chars(p, p + 24, vertices[i]->p_[k]).ptr;
+            }
+            *p++ = '\n';
+            buffer.commit(p);
+        }
+    });
+    if (!ok) return false;
+
+    return writeBlocks(file, pool, layout.chunks.chunk_count(), [&](size_t chunk, std::string& out) {
+        BlockBuffer buffer(out);
+        std::vector<uint32_t> scratch;
+        for (size_t i = layout.chunks.chunk_begin(chunk); i < layout.chunks.chunk_end(chunk); i++) {
+            layout.forEachPolygon(i, mesh, scratch, [&](const uint32_t* ids, size_t count) {
+                char* p = buffer.room(2 + count * 12);
+                *p++ = 'f';
+                for (size_t k = 0; k < count; k++) {
+                    *p++ = ' ';
+                    p = std::to_chars(p, p + 11, ids[k] + 1).ptr;   // OBJ 下标从1开始
+                }
+                *p++ = '\n';
+                buffer.commit(p);
+            });
+        }
+    });
+}
+
+//--- 二进制 STL ---//
+
+bool exportStl(std::FILE* file, const TriangleMesh& mesh, ThreadPool& pool) {
+    char header[80] = {};
+    std::snprintf(header, sizeof(header), "HW3 export");
+    uint32_t count = (uint32_t)mesh.triangleCount();
+    if (std::fwrite(header, 1, sizeof(header), file) != sizeof(header) ||
+        std::fwrite(&count, sizeof(count), 1, file) != 1) return false;
+
+    size_t blocks = (mesh.triangleCount() + TRIANGLE_BLOCK - 1) / TRIANGLE_BLOCK;
+    return writeBlocks(file, pool, blocks, [&](size_t block, std::string& out) {
+        size_t begin = block * TRIANGLE_BLOCK;
+        size_t end = std::min(mesh.triangleCount(), begin + TRIANGLE_BLOCK);
+        out.resize((end - begin) * STL_RECORD);
+        char* p = &out[0];
+        for (size_t t = begin; t < end; t++) {
+            const Point3D* corners[4] = {
+                &mesh.faceNormals[mesh.triangleFaces[t]],
+                &mesh.positions[mesh.indices[t * 3]],
+                &mesh.positions[mesh.indices[t * 3 + 1]],
+                &mesh.positions[mesh.indices[t * 3 + 2]]
+            };
+            for (const Point3D* c : corners) {
+                float xyz[3] = {c->x, c->y, c->z};
+                std::memcpy(p, xyz, sizeof(xyz));
+                p += sizeof(xyz);
+            }
+            *p++ = 0;
+            *p++ = 0;
+        }
+    });
+}
+
+//--- 二进制 PLY ---//
+
+bool exportPly(std::FILE* file, const Body* body, const TriangleMesh& mesh, ThreadPool& pool) {
+    // 顶点数列表的长度为 uchar，超过 255 个顶点的面改为输出三角形
+    FaceLayout layout(body, mesh, pool, 255);
+    const std::vector<Vertex*>& vertices = body->vertices_;
+
+    char header[512];
+    int n = std::snprintf(header, sizeof(header),
+                          "ply\nformat binary_little_endian 1.0\ncomment HW3 export\n"
+                          "element vertex %zu\nproperty float x\nproperty float y\nproperty float z\n"
+                          "element face %zu\nproperty list uchar int vertex_indices\nend_header\n",
+                          vertices.size(), layout.outputFaces);
+    if (std::fwrite(header, 1, (size_t)n, file) != (size_t)n) return false;
+
+    size_t vertexBlocks = (vertices.size() + VERTEX_BLOCK - 1) / VERTEX_BLOCK;
+    bool ok = writeBlocks(file, pool, vertexBlocks, [&](size_t block, std::string& out) {
+        size_t begin = block * VERTEX_BLOCK;
+        size_t end = std::min(vertices.size(), begin + VERTEX_BLOCK);
+        out.resize((end - begin) * 3 * sizeof(float));
+        char* p = &out[0];
+        for (size_t i = begin; i < end; i++) {
+            float xyz[3] = {(float)vertices[i]->p_[0], (float)vertices[i]->p_[1], (float)vertices[i]->p_[2]};
+            std::memcpy(p, xyz, sizeof(xyz));
+            p += sizeof(xyz);
+        }
+    });
+    if (!ok) return false;
+
+    return writeBlocks(file, pool, layout.chunks.chunk_count(), [&](size_t chunk, std::string& out) {
+        BlockBuffer buffer(out);
+        std::vector<uint32_t> scratch;
+        for (size_t i = layout.chunks.chunk_begin(chunk); i < layout.chunks.chunk_end(chunk); i++) {
+            layout.forEachPolygon(i, mesh, scratch, [&](const uint32_t* ids, size_t count) {
+                char* p = buffer.room(1 + count * sizeof(int32_t));
+                *p++ = (char)(uint8_t)count;
+                std::memcpy(p, ids, count * sizeof(int32_t));
+                buffer.commit(p + count * sizeof(int32_t));
+            });
+        }
+    });
+}
+
+} // namespace
+
+bool exportFormatFromPath(const std::string& path, ExportFormat& format) {
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = path.substr(dot + 1);
+    for (char& c : ext) c = (char)std::tolower((unsigned char)c);
+    if (ext == "obj") format = EXPORT_OBJ;
+    else if (ext == "stl") format = EXPORT_STL;
+    else if (ext == "ply") format = EXPORT_PLY;
+    else return false;
+    return true;
+}
+
+bool exportBody(const Body* body, const TriangleMesh& mesh, const std::string& path,
+                ExportFormat format, ThreadPool& pool, std::string* error) {
+    if (!body) return fail(error, "没有可导出的模型");
+    if (mesh.positions.size() != body->vertices_.size()) return fail(error, "三角网格与实体不对应，请先调用 tessellateBody");
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return fail(error, "无法创建 " + path);
+    // 每次写入的都是整块数据，不需要标准库再做一层缓冲
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    bool ok = false;
+    switch (format) {
+    case EXPORT_OBJ: ok = exportObj(file, body, mesh, pool); break;
+    case EXPORT_STL: ok = exportStl(file, mesh, pool); break;
+    case EXPORT_PLY: ok = exportPly(file, body, mesh, pool); break;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    return ok || fail(error, "写入 " + path + " 失败");
+}
@@ -0,0 +1,29 @@
+#ifndef _MODEL_EXPORT_H_
+#define _MODEL_EXPORT_H_
+
+#include <string>
+#include "SolidModel.h"
+#include "Tessellation.h"
+#include "ThreadPool.h"
+
+// 把实体导出为 OBJ、二进制 STL 或二进制 PLY
+// 顶点直接取自 Body::vertices_（OBJ / PLY 中的下标即 Vertex::id_），只有一个环的面按外环输出为多边形，
+// 带内环的面和 STL 使用 tessellateBody 的三角形。
+// 输出按块生成：线程池上的线程用 std::to_chars 格式化下一批块的同时，调用线程把上一批整块写入文件，
+// 因此导出大模型时耗时主要在磁盘写入上。
+
+enum ExportFormat {
+    EXPORT_OBJ,
+    EXPORT_STL,
+    EXPORT_PLY
+};
+
+// 按扩展名（.obj / .stl / .ply，不区分大小写）判断格式
+bool exportFormatFromPath(const std::string& path, ExportFormat& format);
+
+// mesh 必须是同一实体 tessellateBody 的结果；失败时返回 false 并在 error 中给出原因
+// 不能在 pool 的任务内部调用
+bool exportBody(const Body* body, const TriangleMesh& mesh, const std::string& path,
+                ExportFormat format, ThreadPool& pool, std::string* error);
+
+#endif // !_MODEL_EXPORT_H_
@@ -0,0 +1,134 @@
+#include "ModelLoader.h"
+#include <exception>
+#include <iostream>
+#include "FeatureEdges.h"
+
+ModelLoader::~ModelLoader() {
+    cancel();
+}
+
+void ModelLoader::start(BuildStep _build, FinishStep _finish, std::function<void()> _notify) {
+    cancel();
+    cancel_ = false;
+    finished_ = false;
+    notified_ = false;
+    notify_ = std::move(_notify);
+    thread_ = std::thread([this, build = std::move(_build), finish = std::move(_finish)] { run(build, finish); });
+}
+
+void ModelLoader::cancel() {
+    cancel_ = true;
+    if (thread_.joinable()) thread_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    delete body_;
+    body_ = nullptr;
+    pending_ = LoadPreview();
+    changed_ = false;
+}
+
+void ModelLoader::run(const BuildStep& _build, const FinishStep& _finish) {
+    Body* body = nullptr;
+    try {
+        body = _build(*this);
+        if (body && cancelled()) {
+            delete body;
+            body = nullptr;
+        }
+        if (body && _finish) _finish(body);
+    } catch (const std::exception& e) {
+        std::cerr << "后台加载模型失败: " << e.what() << std::endl;
+        delete body;
+        body = nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = body;
+    }
+    finished_ = true;
+    notify();
+}
+
+void ModelLoader::notify() {
+    // 界面线程尚未处理上一次通知时不再重复通知，新内容会在那次处理中一并取走
+    if (notify_ && !notified_.exchange(true)) notify_();
+}
+
+void ModelLoader::publish_bounds(const Point3D& _min, const Point3D& _max) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.hasBounds = true;
+        pending_.min = _min;
+        pending_.max = _max;
+        changed_ = true;
+    }
+    notify();
+}
+
+void ModelLoader::publish_bounds(const Body* _body) {
+    if (!_body) return;
+    double lo[3] = {0, 0, 0}, hi[3] = {0, 0, 0};
+    bool first = true;
+    for (const Vertex* v : _body->vertices_) {
+        if (!v) continue;
+        for (int k = 0; k < 3; k++) {
+            if (first || v->p_[k] < lo[k]) lo[k] = v->p_[k];
+            if (first || v->p_[k] > hi[k]) hi[k] = v->p_[k];
+        }
+        first = false;
+    }
+    if (first) return;
+    publish_bounds(Point3D{(float)lo[0], (float)lo[1], (float)lo[2]}, Point3D{(float)hi[0], (float)hi[1], (float)hi[2]});
+}
+
+void ModelLoader::publish_segments(std::vector<LineSegment3D>&& _segments) {
+    if (_segments.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.segments.empty()) {
+            pending_.segments = std::move(_segments);
+        } else {
+            pending_.segments.insert(pending_.segments.end(), _segments.begin(), _segments.end());
+        }
+        changed_ = true;
+    }
+    _segments.clear();
+    notify();
+}
+
+void ModelLoader::publish_edges(const Body* _body) {
+    if (!_body) return;
+
+    // 先在锁外取出端点坐标，锁内只做一次追加
+    std::vector<LineSegment3D> chunk;
+    chunk.reserve(_body->edges_.size());
+    for (const Edge* e : _body->edges_) {
+        if (!isDrawableEdge(e)) continue;
+        const Point& a = e->he0_->start_vertex_->p_;
+        const Point& b = e->he0_->to_vertex_->p_;
+        chunk.push_back(LineSegment3D{{(float)a[0], (float)a[1], (float)a[2]}, {(float)b[0], (float)b[1], (float)b[2]}});
+    }
+    publish_segments(std::move(chunk));
+}
+
+bool ModelLoader::take_preview(LoadPreview& _preview) {
+    notified_ = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!changed_) return false;
+    if (pending_.hasBounds) {
+        _preview.hasBounds = true;
+        _preview.min = pending_.min;
+        _preview.max = pending_.max;
+    }
+    _preview.segments.insert(_preview.segments.end(), pending_.segments.begin(), pending_.segments.end());
+    pending_.segments.clear();
+    changed_ = false;
+    return true;
+}
+
+Body* ModelLoader::take_body() {
+    if (!finished()) return nullptr;
+    std::lock_guard<std::mutex> lock(mutex_);
+    Body* body = body_;
+    body_ = nullptr;
+    return body;
+}
@@ -0,0 +1,85 @@
+#ifndef _MODEL_LOADER_H_
+#define _MODEL_LOADER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Rendering.h"
+#include "SolidModel.h"
+
+// 模型的后台加载
+// 构建（重放脚本或执行欧拉操作）以及之后的校验、三角化、生成线框都在一个后台线程上进行，界面线程只取结果，从不等待。
+// 构建过程中后台线程陆续提交预览：先是包围盒，然后是按块提交的已构建的边；界面线程收到通知后用 take_preview
+// 取走新增的部分，先显示包围盒，再逐步显示已完成的边，最后换成完整的模型。
+// 通知是合并的：界面线程取走之前，后台线程继续追加预览但不再重复通知，界面线程处理不过来时不会堆积消息。
+// 后台线程本身不是线程池中的任务，因为校验和三角化要在线程池上 wait()，不能在池中的任务里进行。
+
+// 构建中的预览
+typedef struct LoadPreview
+{
+    bool hasBounds = false;
+    Point3D min = {0, 0, 0};
+    Point3D max = {0, 0, 0};
+    std::vector<LineSegment3D> segments;   // 已构建的边，按提交顺序排列；之后被删除的边（如桥边）也保留
+} LoadPreview;
+
+class ModelLoader
+{
+public:
+    // 构建步骤：返回构建好的实体（所有权交给加载器），失败时返回 nullptr
+    // 可通过加载器提交预览，并应不时检查 cancelled()
+    typedef std::function<Body*(ModelLoader&)> BuildStep;
+    // 构建成功后的准备步骤，仍在后台线程上执行，可以使用线程池；用于三角化、生成显示数据等
+    typedef std::function<void(Body*)> FinishStep;
+
+    ModelLoader() = default;
+    ~ModelLoader();
+
+    ModelLoader(const ModelLoader&) = delete;
+    ModelLoader& operator=(const ModelLoader&) = delete;
+
+    // 启动后台线程；_notify 在有新的预览或加载结束时于后台线程上调用（例如向窗口 PostMessage）
+    void start(BuildStep _build, FinishStep _finish, std::function<void()> _notify);
+
+    /** 请求取消并等待后台线程结束；未取走的实体随之释放 */
+    void cancel();
+    bool cancelled() const { return cancel_.load(); }
+
+    // 以下由后台线程调用
+
+    void publish_bounds(const Point3D& _min, const Point3D& _max);
+    /** 以实体当前所有顶点的范围作为包围盒 */
+    void publish_bounds(const Body* _body);
+    /** 追加一批已构建的边，取走 _segments 的内容 */
+    void publish_segments(std::vector<LineSegment3D>&& _segments);
+    /** 提交 _body 当前的全部边；构建过程中分批提交时不能以 edges_ 的下标为断点（kemr 删除边后其后的下标前移），应改用 publish_segments */
+    void publish_edges(const Body* _body);
+
+    // 以下由界面线程调用
+
+    /** 把上次以来新增的预览并入 _preview，返回是否有新内容；须在 finished() 之前调用，才不会漏掉结束的通知 */
+    bool take_preview(LoadPreview& _preview);
+    /** 加载已结束（成功或失败）；为 true 时准备步骤写入的数据对界面线程可见 */
+    bool finished() const { return finished_.load(); }
+    /** 取走构建好的实体，加载结束前或失败时返回 nullptr；只能取一次 */
+    Body* take_body();
+
+private:
+    void run(const BuildStep& _build, const FinishStep& _finish);
+    void notify();
+
+    std::thread thread_;
+    std::function<void()> notify_;
+    std::mutex mutex_;                    // 保护 pending_、changed_ 和 body_
+    LoadPreview pending_;                 // 尚未被取走的预览（segments 只含新增部分）
+    bool changed_ = false;
+    Body* body_ = nullptr;
+    std::atomic<bool> notified_{false};   // 已通知、界面线程尚未取走
+    std::atomic<bool> cancel_{false};
+    std::atomic<bool> finished_{false};
+};
+
+#endif // !_MODEL_LOADER_H_
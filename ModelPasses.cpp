@@ -0,0 +1,147 @@
+#include "ModelPasses.h"
+#include <algorithm>
+#include <sstream>
+#include "Tessellation.h"
+#include "Topology.h"
+
+namespace {
+
+const size_t MAX_MESSAGES = 16;
+
+inline Point3D toPoint3D(const Point& p) {
+    return Point3D{(float)p[0], (float)p[1], (float)p[2]};
+}
+
+// 按块输出、再按块顺序拼接，使结果与顺序遍历一致
+template <class T, class Emit>
+void gatherByChunk(ThreadPool& pool, const FaceChunks& chunks, std::vector<T>& out, Emit emit) {
+    std::vector<std::vector<T>> parts(chunks.chunk_count());
+    parallelForChunks(pool, chunks.chunk_count(), [&](size_t chunk, unsigned) {
+        std::vector<T>& part = parts[chunk];
+        const std::vector<Face*>& faces = chunks.faces();
+        for (size_t i = chunks.chunk_begin(chunk); i < chunks.chunk_end(chunk); i++) {
+            emit(faces[i], part);
+        }
+    });
+
+    size_t total = 0;
+    for (const std::vector<T>& part : parts) total += part.size();
+    out.clear();
+    out.reserve(total);
+    for (const std::vector<T>& part : parts) out.insert(out.end(), part.begin(), part.end());
+}
+
+void report(ValidationReport& r, const Face* face, const char* what) {
+    if (r.messages.size() < MAX_MESSAGES) {
+        std::ostringstream os;
+        os << "面 " << face << ": " << what;
+        r.messages.push_back(os.str());
+    }
+    r.errorCount++;
+}
+
+} // namespace
+
+void BoundingBox::expand(const Point3D& p) {
+    if (empty) {
+        min = max = p;
+        empty = false;
+        return;
+    }
+    min.x = std::min(min.x, p.x); max.x = std::max(max.x, p.x);
+    min.y = std::min(min.y, p.y); max.y = std::max(max.y, p.y);
+    min.z = std::min(min.z, p.z); max.z = std::max(max.z, p.z);
+}
+
+void BoundingBox::merge(const BoundingBox& other) {
+    if (other.empty) return;
+    expand(other.min);
+    expand(other.max);
+}
+
+Point3D BoundingBox::center() const {
+    if (empty) return Point3D{0.0f, 0.0f, 0.0f};
+    return Point3D{(min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f};
+}
+
+BoundingBox computeBoundingBox(ThreadPool& pool, const FaceChunks& chunks) {
+    return parallelReduceFaces(pool, chunks, BoundingBox(),
+        [](BoundingBox& box, const Face* face) {
+            for (const Loop* loop : loops(face)) {
+                for (const Vertex* v : loopVertices(loop)) {
+                    box.expand(toPoint3D(v->p_));
+                }
+            }
+        },
+        [](BoundingBox& box, const BoundingBox& part) { box.merge(part); });
+}
+
+void computeFaceNormals(ThreadPool& pool, const FaceChunks& chunks, std::vector<Point3D>& normals) {
+    normals.assign(chunks.face_count(), Point3D{0.0f, 0.0f, 0.0f});
+    parallelForFaces(pool, chunks, [&normals](size_t index, Face* face, unsigned) {
+        normals[index] = faceNormal(face);
+    });
+}
+
+void extractEdgeSegments(ThreadPool& pool, const FaceChunks& chunks, std::vector<LineSegment3D>& segments) {
+    gatherByChunk(pool, chunks, segments, [](const Face* face, std::vector<LineSegment3D>& out) {
+        for (const Loop* loop : loops(face)) {
+            for (const Halfedge* he : halfedges(loop)) {
+                if (!he->edge_ || he->edge_->he0_ != he) continue;
+                if (!he->start_vertex_ || !he->to_vertex_) continue;
+                out.push_back(LineSegment3D{toPoint3D(he->start_vertex_->p_), toPoint3D(he->to_vertex_->p_)});
+            }
+        }
+    });
+}
+
+ValidationReport validateBody(ThreadPool& pool, const FaceChunks& chunks) {
+    const Body* body = chunks.body();
+    ValidationReport result = parallelReduceFaces(pool, chunks, ValidationReport(),
+        [body](ValidationReport& r, const Face* face) {
+            r.faceCount++;
+            if (face->body_ != body) report(r, face, "body_ 不指向所属实体");
+            if (!face->first_loop_) report(r, face, "没有环");
+
+            for (const Loop* loop : loops(face)) {
+                r.loopCount++;
+                if (loop->face_ != face) report(r, face, "环的 face_ 不指向该面");
+                if (!loop->start_he_) {
+                    report(r, face, "环没有起始半边");
+                    continue;
+                }
+                for (const Halfedge* he : halfedges(loop)) {
+                    r.halfedgeCount++;
+                    if (he->loop_ != loop) report(r, face, "半边的 loop_ 不指向所在环");
+                    if (!he->next_he_ || he->next_he_->prev_he_ != he) report(r, face, "next_he_/prev_he_ 不互逆");
+                    else if (he->to_vertex_ != he->next_he_->start_vertex_) report(r, face, "半边终点与后继起点不同");
+                    if (!he->oppo_he_ || he->oppo_he_->oppo_he_ != he) report(r, face, "对边不对称");
+                    else if (he->oppo_he_->start_vertex_ != he->to_vertex_ ||
+                             he->oppo_he_->to_vertex_ != he->start_vertex_) report(r, face, "对边端点不匹配");
+                    if (!he->edge_ || (he->edge_->he0_ != he && he->edge_->he1_ != he)) report(r, face, "半边不属于其 edge_");
+                    // 环断开时迭代器在 nullptr 处结束，上面已记录
+                }
+            }
+        },
+        [](ValidationReport& r, const ValidationReport& part) {
+            r.faceCount += part.faceCount;
+            r.loopCount += part.loopCount;
+            r.halfedgeCount += part.halfedgeCount;
+            r.errorCount += part.errorCount;
+            for (const std::string& m : part.messages) {
+                if (r.messages.size() >= MAX_MESSAGES) break;
+                r.messages.push_back(m);
+            }
+        });
+
+    // 计数与链表的一致性只需顺序检查一次
+    if (body && result.faceCount != (size_t)std::max(body->face_num_, 0)) {
+        result.errorCount++;
+        if (result.messages.size() < MAX_MESSAGES) result.messages.push_back("face_num_ 与面链表长度不符");
+    }
+    if (body && result.halfedgeCount != body->edges_.size() * 2) {
+        result.errorCount++;
+        if (result.messages.size() < MAX_MESSAGES) result.messages.push_back("半边数不等于边数的两倍");
+    }
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef _MODEL_PASSES_H_
+#define _MODEL_PASSES_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "ParallelFaces.h"
+#include "Rendering.h"
+
+// 基于 ParallelFaces 的整体遍历：包围盒、面法向、线框提取与拓扑校验
+// 各函数只读实体，可与其他只读遍历同时进行；结果与顺序遍历 next_face_ 链表得到的一致
+
+// 轴对齐包围盒
+typedef struct BoundingBox
+{
+    Point3D min;
+    Point3D max;
+    bool empty = true;
+
+    void expand(const Point3D& p);
+    void merge(const BoundingBox& other);
+    Point3D center() const;
+} BoundingBox;
+
+// 拓扑校验结果
+typedef struct ValidationReport
+{
+    size_t faceCount = 0;
+    size_t loopCount = 0;
+    size_t halfedgeCount = 0;
+    size_t errorCount = 0;
+    std::vector<std::string> messages;   // 最多保留前若干条错误描述
+
+    bool ok() const { return errorCount == 0; }
+} ValidationReport;
+
+// 所有面上顶点的包围盒（悬空的孤立顶点不计入）
+BoundingBox computeBoundingBox(ThreadPool& pool, const FaceChunks& chunks);
+
+// 逐面计算单位法向（外环 Newell 法向），结果按 chunks.faces() 的顺序写入 normals
+void computeFaceNormals(ThreadPool& pool, const FaceChunks& chunks, std::vector<Point3D>& normals);
+
+// 提取线框，每条边在其 he0_ 一侧输出一次，顺序与 modelToLineSegments 相同
+void extractEdgeSegments(ThreadPool& pool, const FaceChunks& chunks, std::vector<LineSegment3D>& segments);
+
+// 检查半边结构的一致性：next/prev 互逆、首尾相接、对边对称、边与环/面/体的归属
+ValidationReport validateBody(ThreadPool& pool, const FaceChunks& chunks);
+
+#endif // !_MODEL_PASSES_H_
@@ -0,0 +1,91 @@
+#include "ParallelFaces.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include "Topology.h"
+
+FaceChunks::FaceChunks(const Body* _body, size_t _chunk_size)
+    : body_(_body), chunk_size_(std::max<size_t>(_chunk_size, 1)) {
+    if (!_body) return;
+    faces_.reserve((size_t)std::max(_body->face_num_, 0));
+    for (Face* face : ::faces(_body)) {
+        faces_.push_back(face);
+    }
+}
+
+namespace {
+
+// 每个线程剩余的块区间 [begin_, end_)，自己从前端取，窃取者从末端取
+struct WorkRange {
+    std::mutex mutex_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+};
+
+bool popFront(WorkRange& _range, size_t& _chunk) {
+    std::lock_guard<std::mutex> lock(_range.mutex_);
+    if (_range.begin_ >= _range.end_) return false;
+    _chunk = _range.begin_++;
+    return true;
+}
+
+// 从 _victim 末端窃取一半（至少一块）放入 _thief
+bool stealHalf(WorkRange& _victim, WorkRange& _thief) {
+    size_t begin, end;
+    {
+        std::lock_guard<std::mutex> lock(_victim.mutex_);
+        if (_victim.begin_ >= _victim.end_) return false;
+        end = _victim.end_;
+        begin = end - (end - _victim.begin_ + 1) / 2;
+        _victim.end_ = begin;
+    }
+    std::lock_guard<std::mutex> lock(_thief.mutex_);
+    _thief.begin_ = begin;
+    _thief.end_ = end;
+    return true;
+}
+
+} // namespace
+
+void parallelForChunks(ThreadPool& _pool, size_t _chunk_count, const std::function<void(size_t, unsigned)>& _fn) {
+    unsigned workers = (unsigned)std::min<size_t>(_pool.size(), _chunk_count);
+    if (workers <= 1) {
+        for (size_t c = 0; c < _chunk_count; c++) _fn(c, 0);
+        return;
+    }
+
+    std::unique_ptr<WorkRange[]> ranges(new WorkRange[workers]);
+    for (unsigned w = 0; w < workers; w++) {
+        ranges[w].begin_ = _chunk_count * w / workers;
+        ranges[w].end_ = _chunk_count * (w + 1) / workers;
+    }
+
+    for (unsigned w = 0; w < workers; w++) {
+        _pool.submit([&ranges, &_fn, workers, w] {
+            for (;;) {
+                size_t chunk;
+                if (popFront(ranges[w], chunk)) {
+                    _fn(chunk, w);
+                    continue;
+                }
+                // 自己的部分已做完，依次尝试从其他线程窃取；都没有剩余时退出
+                bool stolen = false;
+                for (unsigned k = 1; k < workers && !stolen; k++) {
+                    stolen = stealHalf(ranges[(w + k) % workers], ranges[w]);
+                }
+                if (!stolen) return;
+            }
+        });
+    }
+    _pool.wait();
+}
+
+void parallelForFaces(ThreadPool& _pool, const FaceChunks& _chunks,
+                      const std::function<void(size_t, Face*, unsigned)>& _fn) {
+    const std::vector<Face*>& faces = _chunks.faces();
+    parallelForChunks(_pool, _chunks.chunk_count(), [&](size_t _chunk, unsigned _worker) {
+        for (size_t i = _chunks.chunk_begin(_chunk); i < _chunks.chunk_end(_chunk); i++) {
+            _fn(i, faces[i], _worker);
+        }
+    });
+}
@@ -0,0 +1,70 @@
+#ifndef _PARALLEL_FACES_H_
+#define _PARALLEL_FACES_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "SolidModel.h"
+#include "ThreadPool.h"
+
+// 按面并行处理实体的框架
+// 面以 next_face_ 链表相连，无法直接切分；FaceChunks 先顺序遍历一次把面指针收集到数组，
+// 再按固定大小切成连续的块。各块交给工作窃取的并行循环处理，结果按线程局部累加后再合并。
+
+// 面的连续分块，块的顺序与 next_face_ 链表顺序一致
+class FaceChunks
+{
+public:
+    explicit FaceChunks(const Body* _body, size_t _chunk_size = 256);
+
+    size_t face_count() const { return faces_.size(); }
+    size_t chunk_count() const { return (faces_.size() + chunk_size_ - 1) / chunk_size_; }
+    size_t chunk_size() const { return chunk_size_; }
+
+    /** 第 _chunk 块在 faces() 中的起止下标 */
+    size_t chunk_begin(size_t _chunk) const { return _chunk * chunk_size_; }
+    size_t chunk_end(size_t _chunk) const { return std::min(faces_.size(), (_chunk + 1) * chunk_size_); }
+
+    const std::vector<Face*>& faces() const { return faces_; }
+    const Body* body() const { return body_; }
+
+private:
+    const Body* body_;
+    size_t chunk_size_;
+    std::vector<Face*> faces_;
+};
+
+// 工作窃取的并行循环：块下标先均分给各线程，线程做完自己的部分后从其他线程剩余部分的末尾窃取一半
+// _fn(块下标, 线程序号)，线程序号小于 _pool.size()
+// 在 _pool 上等待全部任务完成后返回；不能在该线程池的任务内部调用
+void parallelForChunks(ThreadPool& _pool, size_t _chunk_count, const std::function<void(size_t, unsigned)>& _fn);
+
+// 对每个面执行 _fn(面下标, 面, 线程序号)
+void parallelForFaces(ThreadPool& _pool, const FaceChunks& _chunks,
+                      const std::function<void(size_t, Face*, unsigned)>& _fn);
+
+// 线程局部累加后合并：每个线程从 _identity 开始用 _map(累加值, 面) 累加，最后按线程序号依次 _combine
+template <class T, class Map, class Combine>
+T parallelReduceFaces(ThreadPool& _pool, const FaceChunks& _chunks, const T& _identity, Map _map, Combine _combine)
+{
+    // 相邻线程的累加值之间隔开一个缓存行，避免伪共享
+    // （C++14 的 new 不保证 alignas(64)，这里用填充代替对齐）
+    struct Slot { T value_; char pad_[64]; };
+    std::vector<Slot> partial(_pool.size(), Slot{_identity, {}});
+
+    parallelForChunks(_pool, _chunks.chunk_count(), [&](size_t _chunk, unsigned _worker) {
+        T& acc = partial[_worker].value_;
+        const std::vector<Face*>& faces = _chunks.faces();
+        for (size_t i = _chunks.chunk_begin(_chunk); i < _chunks.chunk_end(_chunk); i++)
+        {
+            _map(acc, faces[i]);
+        }
+    });
+
+    T result = _identity;
+    for (const Slot& slot : partial) _combine(result, slot.value_);
+    return result;
+}
+
+#endif // !_PARALLEL_FACES_H_
@@ -0,0 +1,155 @@
+#include "Predicates.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// 双精度的单位舍入 2^-53
+const double EPSILON = 1.1102230246251565e-16;
+const double SPLITTER = 134217729.0;   // 2^27 + 1
+const double CCW_ERRBOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+const double O3D_ERRBOUND = (7.0 + 56.0 * EPSILON) * EPSILON;
+
+// 浮点展开式：若干个互不重叠的分量按绝对值从小到大排列，其和为精确值
+typedef std::vector<double> Expansion;
+
+// a + b = x + y，x 为浮点和，y 为舍入误差
+inline void twoSum(double a, double b, double& x, double& y) {
+    x = a + b;
+    double bv = x - a;
+    double av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+inline void twoDiff(double a, double b, double& x, double& y) {
+    x = a - b;
+    double bv = a - x;
+    double av = x + bv;
+    y = (a - av) + (bv - b);
+}
+
+inline void split(double a, double& hi, double& lo) {
+    double c = SPLITTER * a;
+    double big = c - a;
+    hi = c - big;
+    lo = a - hi;
+}
+
+// a * b = x + y（Dekker 乘法）
+inline void twoProduct(double a, double b, double& x, double& y) {
+    x = a * b;
+    double ahi, alo, bhi, blo;
+    split(a, ahi, alo);
+    split(b, bhi, blo);
+    double err1 = x - ahi * bhi;
+    double err2 = err1 - alo * bhi;
+    double err3 = err2 - ahi * blo;
+    y = alo * blo - err3;
+}
+
+Expansion difference(double a, double b) {
+    double x, y;
+    twoDiff(a, b, x, y);
+    return Expansion{y, x};
+}
+
+// e + b，逐个分量累加（GROW-EXPANSION），结果去掉零分量
+Expansion grow(const Expansion& e, double b) {
+    Expansion h;
+    h.reserve(e.size() + 1);
+    double q = b;
+    for (double ei : e) {
+        double sum, err;
+        twoSum(q, ei, sum, err);
+        q = sum;
+        if (err != 0) h.push_back(err);
+    }
+    if (q != 0 || h.empty()) h.push_back(q);
+    return h;
+}
+
+Expansion add(const Expansion& e, const Expansion& f) {
+    Expansion h = e;
+    for (double fi : f) h = grow(h, fi);
+    return h;
+}
+
+Expansion negate(Expansion e) {
+    for (double& x : e) x = -x;
+    return e;
+}
+
+// e * b（SCALE-EXPANSION），结果去掉零分量
+Expansion scale(const Expansion& e, double b) {
+    Expansion h;
+    h.reserve(e.size() * 2);
+    double q, hh;
+    twoProduct(e[0], b, q, hh);
+    if (hh != 0) h.push_back(hh);
+    for (size_t i = 1; i < e.size(); i++) {
+        double p1, p0, sum;
+        twoProduct(e[i], b, p1, p0);
+        twoSum(q, p0, sum, hh);
+        if (hh != 0) h.push_back(hh);
+        twoSum(p1, sum, q, hh);
+        if (hh != 0) h.push_back(hh);
+    }
+    if (q != 0 || h.empty()) h.push_back(q);
+    return h;
+}
+
+Expansion multiply(const Expansion& e, const Expansion& f) {
+    Expansion h{0.0};
+    for (double fi : f) h = add(h, scale(e, fi));
+    return h;
+}
+
+// 去掉零分量后，最大的分量决定符号
+double sign(const Expansion& e) {
+    return e.back();
+}
+
+double orient2dExact(const double* a, const double* b, const double* c) {
+    Expansion acx = difference(a[0], c[0]), acy = difference(a[1], c[1]);
+    Expansion bcx = difference(b[0], c[0]), bcy = difference(b[1], c[1]);
+    return sign(add(multiply(acx, bcy), negate(multiply(acy, bcx))));
+}
+
+double orient3dExact(const double* a, const double* b, const double* c, const double* d) {
+    Expansion adx = difference(a[0], d[0]), ady = difference(a[1], d[1]), adz = difference(a[2], d[2]);
+    Expansion bdx = difference(b[0], d[0]), bdy = difference(b[1], d[1]), bdz = difference(b[2], d[2]);
+    Expansion cdx = difference(c[0], d[0]), cdy = difference(c[1], d[1]), cdz = difference(c[2], d[2]);
+
+    Expansion bc = add(multiply(bdx, cdy), negate(multiply(cdx, bdy)));
+    Expansion ca = add(multiply(cdx, ady), negate(multiply(adx, cdy)));
+    Expansion ab = add(multiply(adx, bdy), negate(multiply(bdx, ady)));
+    return sign(add(add(multiply(adz, bc), multiply(bdz, ca)), multiply(cdz, ab)));
+}
+
+} // namespace
+
+double orient2d(const double* a, const double* b, const double* c) {
+    double detLeft = (a[0] - c[0]) * (b[1] - c[1]);
+    double detRight = (a[1] - c[1]) * (b[0] - c[0]);
+    double det = detLeft - detRight;
+    double detSum = std::fabs(detLeft) + std::fabs(detRight);
+    if (std::fabs(det) >= CCW_ERRBOUND * detSum) return det;
+    return orient2dExact(a, b, c);
+}
+
+double orient3d(const double* a, const double* b, const double* c, const double* d) {
+    double adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+    double bdx = b[0] - d[0], bdy = b[1] - d[1], bdz = b[2] - d[2];
+    double cdx = c[0] - d[0], cdy = c[1] - d[1], cdz = c[2] - d[2];
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz)
+                     + (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz)
+                     + (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+    if (std::fabs(det) > O3D_ERRBOUND * permanent) return det;
+    return orient3dExact(a, b, c, d);
+}
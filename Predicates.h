@@ -0,0 +1,15 @@
+#ifndef _PREDICATES_H_
+#define _PREDICATES_H_
+
+// 鲁棒的几何方向谓词（Shewchuk 的自适应方法）
+// 先用浮点运算求行列式，若其绝对值超过舍入误差界就直接返回；否则用浮点展开式精确重算。
+// 返回值的符号总是正确的，绝对值只在快速路径上等于行列式的近似值。
+
+// >0: a、b、c 按逆时针排列；<0: 顺时针；=0: 共线
+double orient2d(const double* a, const double* b, const double* c);
+
+// >0: d 位于平面 abc 的下方（从上方看 a、b、c 为逆时针）；<0: 上方；=0: 四点共面
+// 即 (a-d)·((b-d)×(c-d)) 的符号
+double orient3d(const double* a, const double* b, const double* c, const double* d);
+
+#endif // !_PREDICATES_H_
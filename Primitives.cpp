@@ -0,0 +1,73 @@
+#include "Primitives.h"
+
+Body* instantiateTopology(const TopologyView& _view, const double (*_positions)[3]) {
+    Body* body = new Body();
+    body->reserve(_view.vertexCount, _view.edgeCount, _view.faceCount, _view.loopCount);
+    BodyArena& arena = body->arena_;
+
+    auto vertices = arena.create_n<Vertex>(_view.vertexCount,
+        [_positions](size_t i) { return Vertex{Point(_positions[i])}; });
+    auto halfedges = arena.create_n<Halfedge>(2 * _view.edgeCount);
+    auto edges = arena.create_n<Edge>(_view.edgeCount,
+        [&halfedges](size_t e) { return Edge{halfedges[2 * e], halfedges[2 * e + 1]}; });
+    auto loops = arena.create_n<Loop>(_view.loopCount);
+    auto faces = arena.create_n<Face>(_view.faceCount);
+
+    for (size_t i = 0; i < _view.vertexCount; i++) body->add_vertex(vertices[i]);
+    for (size_t e = 0; e < _view.edgeCount; e++) body->edges_.push_back(edges[e]);
+
+    // 面按编号串成双向链表
+    for (size_t f = 0; f < _view.faceCount; f++) {
+        Face* face = faces[f];
+        face->body_ = body;
+        face->prev_face_ = f > 0 ? faces[f - 1] : nullptr;
+        face->next_face_ = f + 1 < _view.faceCount ? faces[f + 1] : nullptr;
+    }
+    body->first_face_ = _view.faceCount > 0 ? faces[0] : nullptr;
+
+    // 半边的端点、所在的边和对边只取决于编号
+    for (size_t h = 0; h < 2 * _view.edgeCount; h++) {
+        Halfedge* he = halfedges[h];
+        he->start_vertex_ = vertices[_view.edgeVertices[h]];
+        he->to_vertex_ = vertices[_view.edgeVertices[h ^ 1]];
+        he->edge_ = edges[h >> 1];
+        he->oppo_he_ = halfedges[h ^ 1];
+        he->start_vertex_->he_ = he;
+    }
+
+    // 环内的前驱、后继按表中的顺序连接；同一个面的各环按表中的顺序挂到面的环链表末尾
+    for (size_t l = 0; l < _view.loopCount; l++) {
+        Loop* loop = loops[l];
+        Face* face = faces[_view.loopFace[l]];
+        loop->face_ = face;
+        if (!face->first_loop_) {
+            face->first_loop_ = loop;
+        } else {
+            Loop* last = face->first_loop_;
+            while (last->next_loop_) last = last->next_loop_;
+            last->next_loop_ = loop;
+            loop->prev_loop_ = last;
+        }
+
+        const uint32_t begin = _view.loopBegin[l], end = _view.loopBegin[l + 1];
+        loop->start_he_ = halfedges[_view.loopHalfedges[begin]];
+        for (uint32_t k = begin; k < end; k++) {
+            Halfedge* he = halfedges[_view.loopHalfedges[k]];
+            he->loop_ = loop;
+            he->next_he_ = halfedges[_view.loopHalfedges[k + 1 < end ? k + 1 : begin]];
+            he->prev_he_ = halfedges[_view.loopHalfedges[k > begin ? k - 1 : end - 1]];
+        }
+    }
+
+    body->face_num_ = (int)_view.faceCount;
+    body->edge_num_ = (int)_view.edgeCount;
+    body->revision_++;
+    return body;
+}
+
+Body* makeBox(const Point& _min, const Point& _max) {
+    const double profile[4][2] = {
+        {_min[0], _min[1]}, {_max[0], _min[1]}, {_max[0], _max[1]}, {_min[0], _max[1]}
+    };
+    return makePrism<4>(profile, _min[2], _max[2]);
+}
@@ -0,0 +1,298 @@
+#ifndef _PRIMITIVES_H_
+#define _PRIMITIVES_H_
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "SolidModel.h"
+
+// 基本体库：长方体、带通孔的长方体、棱柱以及圆柱的多边形近似
+// 连接关系在编译期按段数生成为 constexpr 下标表，实例化时只按表一次性填充实体的记录：
+// 所有记录用 BodyArena::create_n 成批分配，半边的前驱、后继、对边和所在的环直接由下标算出，
+// 不经过欧拉操作，也不需要在环中查找半边。几何坐标仍在运行时给出。
+//
+// 表的约定：第 e 条边的两条半边编号为 2e（从 edgeVertices[2e] 指向 edgeVertices[2e+1]）和 2e+1（反向），
+// 互为对边的两条半边编号只差最低位；各环的半边按环上的顺序依次存放，环从外侧看为逆时针，内环为顺时针。
+
+/** 运行时使用的表视图，与段数无关 */
+typedef struct TopologyView
+{
+    size_t vertexCount;
+    size_t edgeCount;
+    size_t faceCount;
+    size_t loopCount;
+    const uint32_t* edgeVertices;    // 2 * edgeCount：每条边的起点、终点
+    const uint32_t* loopHalfedges;   // 2 * edgeCount：各环的半边编号，按环依次排列
+    const uint32_t* loopBegin;       // loopCount + 1：第 l 个环的半边为 loopHalfedges[loopBegin[l], loopBegin[l+1])
+    const uint32_t* loopFace;        // loopCount：环所在的面
+} TopologyView;
+
+template <size_t V, size_t E, size_t F, size_t L>
+struct TopologyTable
+{
+    static constexpr size_t vertexCount = V;
+    static constexpr size_t edgeCount = E;
+    static constexpr size_t faceCount = F;
+    static constexpr size_t loopCount = L;
+
+    std::array<uint32_t, 2 * E> edgeVertices{};
+    std::array<uint32_t, 2 * E> loopHalfedges{};
+    std::array<uint32_t, L + 1> loopBegin{};
+    std::array<uint32_t, L> loopFace{};
+
+    TopologyView view() const
+    {
+        return TopologyView{V, E, F, L, edgeVertices.data(), loopHalfedges.data(), loopBegin.data(), loopFace.data()};
+    }
+};
+
+namespace primitive_detail
+{
+    // 编译期填表：按顺序追加边、环和环上的半边
+    template <class Table>
+    struct TableWriter
+    {
+        Table& table;
+        size_t halfedges = 0;
+        size_t loops = 0;
+
+        constexpr void edge(size_t _e, uint32_t _from, uint32_t _to)
+        {
+            table.edgeVertices[2 * _e] = _from;
+            table.edgeVertices[2 * _e + 1] = _to;
+        }
+
+        constexpr void loop(uint32_t _face)
+        {
+            table.loopFace[loops] = _face;
+            table.loopBegin[loops] = (uint32_t)halfedges;
+            loops++;
+            table.loopBegin[loops] = (uint32_t)halfedges;
+        }
+
+        /** 当前环追加边 _e 的一条半边，_reversed 为 true 时取从终点指向起点的那条 */
+        constexpr void halfedge(size_t _e, bool _reversed)
+        {
+            table.loopHalfedges[halfedges++] = (uint32_t)(2 * _e + (_reversed ? 1 : 0));
+            table.loopBegin[loops] = (uint32_t)halfedges;
+        }
+
+        /** 顶点 _first 起的 _n 个顶点围成一圈，依次生成第 _edge 起的 _n 条边 */
+        constexpr void ring(uint32_t _first, size_t _n, size_t _edge)
+        {
+            for (size_t i = 0; i < _n; i++) edge(_edge + i, _first + (uint32_t)i, _first + (uint32_t)((i + 1) % _n));
+        }
+
+        /**
+         * 以一圈边为边界的环；_descending 为 false 时沿边的方向前进（从 +z 看为逆时针），
+         * 为 true 时逆着边的方向、按边号递减前进（从 +z 看为顺时针）
+         */
+        constexpr void cap(uint32_t _face, size_t _ring_edge, size_t _n, bool _descending)
+        {
+            loop(_face);
+            for (size_t i = 0; i < _n; i++)
+            {
+                if (_descending) halfedge(_ring_edge + _n - 1 - i, true);
+                else halfedge(_ring_edge + i, false);
+            }
+        }
+
+        /**
+         * 连接底圈与顶圈的 _n 条竖边和 _n 个四边形侧面，竖边 i 从底圈第 i 个顶点指向顶圈第 i 个顶点
+         * _outward 为 true 时侧面朝外（棱柱外壁），否则朝向轴线（通孔内壁）
+         */
+        constexpr void tube(uint32_t _bottom, uint32_t _top, size_t _n, size_t _bottom_edge, size_t _top_edge,
+                            size_t _vertical_edge, uint32_t _first_face, bool _outward)
+        {
+            for (size_t i = 0; i < _n; i++) edge(_vertical_edge + i, _bottom + (uint32_t)i, _top + (uint32_t)i);
+            for (size_t i = 0; i < _n; i++)
+            {
+                size_t j = (i + 1) % _n;
+                loop(_first_face + (uint32_t)i);
+                if (_outward)
+                {
+                    halfedge(_bottom_edge + i, false);
+                    halfedge(_vertical_edge + j, false);
+                    halfedge(_top_edge + i, true);
+                    halfedge(_vertical_edge + i, true);
+                }
+                else
+                {
+                    halfedge(_vertical_edge + i, false);
+                    halfedge(_top_edge + i, false);
+                    halfedge(_vertical_edge + j, true);
+                    halfedge(_bottom_edge + i, true);
+                }
+            }
+        }
+    };
+
+    template <class Table>
+    constexpr TableWriter<Table> writer(Table& _table)
+    {
+        return TableWriter<Table>{_table};
+    }
+
+    /** 编译期检查：每条半边恰好出现在一个环中，且环上相邻两条半边首尾相接 */
+    template <class Table>
+    constexpr bool isClosed(const Table& _table)
+    {
+        std::array<uint32_t, 2 * Table::edgeCount> used{};
+        for (size_t k = 0; k < 2 * Table::edgeCount; k++) used[_table.loopHalfedges[k]]++;
+        for (size_t h = 0; h < used.size(); h++)
+        {
+            if (used[h] != 1) return false;
+        }
+        for (size_t l = 0; l < Table::loopCount; l++)
+        {
+            size_t begin = _table.loopBegin[l], end = _table.loopBegin[l + 1];
+            if (end - begin < 3) return false;
+            for (size_t k = begin; k < end; k++)
+            {
+                uint32_t h = _table.loopHalfedges[k];
+                uint32_t n = _table.loopHalfedges[k + 1 < end ? k + 1 : begin];
+                if (_table.edgeVertices[h ^ 1] != _table.edgeVertices[n]) return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * N 棱柱：底圈顶点 0..N-1、顶圈 N..2N-1（从 +z 看逆时针）
+ * 边：底圈 0..N-1、顶圈 N..2N-1、竖边 2N..3N-1；面：底面 0、顶面 1、侧面 2..N+1（侧面 i 位于顶点 i 与 i+1 之间）
+ */
+template <size_t N>
+using PrismTable = TopologyTable<2 * N, 3 * N, N + 2, N + 2>;
+
+template <size_t N>
+constexpr PrismTable<N> prismTopology()
+{
+    static_assert(N >= 3, "a prism needs at least 3 sides");
+    PrismTable<N> table{};
+    auto w = primitive_detail::writer(table);
+    w.ring(0, N, 0);
+    w.ring(N, N, N);
+    w.cap(0, 0, N, true);
+    w.cap(1, N, N, false);
+    w.tube(0, N, N, 0, N, 2 * N, 2, true);
+    return table;
+}
+
+/**
+ * 沿 z 轴开 M 棱柱形通孔的长方体：外侧与 PrismTable<4> 相同，孔的底圈顶点 8..7+M、顶圈 8+M..7+2M
+ * 孔的边：底圈 12..11+M、顶圈 12+M..11+2M、竖边 12+2M..11+3M；孔壁为面 6..5+M
+ * 底面和顶面各多一个内环，环共 M+8 个
+ */
+template <size_t M>
+using HoledBoxTable = TopologyTable<8 + 2 * M, 12 + 3 * M, 6 + M, 8 + M>;
+
+template <size_t M>
+constexpr HoledBoxTable<M> holedBoxTopology()
+{
+    static_assert(M >= 3, "a hole needs at least 3 sides");
+    HoledBoxTable<M> table{};
+    auto w = primitive_detail::writer(table);
+    w.ring(0, 4, 0);
+    w.ring(4, 4, 4);
+    w.cap(0, 0, 4, true);
+    w.cap(1, 4, 4, false);
+    w.tube(0, 4, 4, 0, 4, 8, 2, true);
+    w.ring(8, M, 12);
+    w.ring(8 + M, M, 12 + M);
+    w.cap(0, 12, M, false);
+    w.cap(1, 12 + M, M, true);
+    w.tube(8, 8 + M, M, 12, 12 + M, 12 + 2 * M, 6, false);
+    return table;
+}
+
+// 表在编译期生成，每种段数只有一份；实例化前用 static_assert 检查表构成封闭曲面
+template <size_t N>
+struct PrismTopology
+{
+    static constexpr PrismTable<N> table = prismTopology<N>();
+};
+
+template <size_t M>
+struct HoledBoxTopology
+{
+    static constexpr HoledBoxTable<M> table = holedBoxTopology<M>();
+};
+
+/**
+ * 按表一次性建立实体：顶点坐标按顶点编号给出，共 _view.vertexCount 个
+ * 顶点、半边、边、环、面各用一次 BodyArena::create_n 分配，返回的实体归调用者所有
+ */
+Body* instantiateTopology(const TopologyView& _view, const double (*_positions)[3]);
+
+/** 轴对齐的长方体，_min、_max 为对角顶点 */
+Body* makeBox(const Point& _min, const Point& _max);
+
+/** 以 xy 平面内逆时针的凸多边形 _profile 为截面、z 从 _z0 到 _z1 的 N 棱柱 */
+template <size_t N>
+Body* makePrism(const double (&_profile)[N][2], double _z0, double _z1)
+{
+    static_assert(primitive_detail::isClosed(PrismTopology<N>::table), "prism table is not a closed surface");
+    double positions[2 * N][3];
+    for (size_t i = 0; i < N; i++)
+    {
+        positions[i][0] = positions[N + i][0] = _profile[i][0];
+        positions[i][1] = positions[N + i][1] = _profile[i][1];
+        positions[i][2] = _z0;
+        positions[N + i][2] = _z1;
+    }
+    return instantiateTopology(PrismTopology<N>::table.view(), positions);
+}
+
+/** 圆柱的 N 棱柱近似：轴线为 z 轴，截面为半径 _radius 的正 N 边形 */
+template <size_t N>
+Body* makeCylinder(double _radius, double _z0, double _z1)
+{
+    double profile[N][2];
+    for (size_t i = 0; i < N; i++)
+    {
+        double a = 2.0 * 3.14159265358979323846 * (double)i / (double)N;
+        profile[i][0] = _radius * std::cos(a);
+        profile[i][1] = _radius * std::sin(a);
+    }
+    return makePrism<N>(profile, _z0, _z1);
+}
+
+/** 沿 z 轴开通孔的长方体，孔的截面 _hole 为 xy 平面内逆时针的凸多边形，须位于长方体截面内部 */
+template <size_t M>
+Body* makeHoledBox(const Point& _min, const Point& _max, const double (&_hole)[M][2])
+{
+    static_assert(primitive_detail::isClosed(HoledBoxTopology<M>::table), "holed box table is not a closed surface");
+    double positions[8 + 2 * M][3] = {
+        {_min[0], _min[1], _min[2]}, {_max[0], _min[1], _min[2]},
+        {_max[0], _max[1], _min[2]}, {_min[0], _max[1], _min[2]},
+        {_min[0], _min[1], _max[2]}, {_max[0], _min[1], _max[2]},
+        {_max[0], _max[1], _max[2]}, {_min[0], _max[1], _max[2]}
+    };
+    for (size_t j = 0; j < M; j++)
+    {
+        positions[8 + j][0] = positions[8 + M + j][0] = _hole[j][0];
+        positions[8 + j][1] = positions[8 + M + j][1] = _hole[j][1];
+        positions[8 + j][2] = _min[2];
+        positions[8 + M + j][2] = _max[2];
+    }
+    return instantiateTopology(HoledBoxTopology<M>::table.view(), positions);
+}
+
+/** 开圆形通孔（正 M 边形近似）的长方体，孔的轴线过长方体截面中心 */
+template <size_t M>
+Body* makeHoledBoxCylinder(const Point& _min, const Point& _max, double _radius)
+{
+    double cx = (_min[0] + _max[0]) / 2, cy = (_min[1] + _max[1]) / 2;
+    double hole[M][2];
+    for (size_t j = 0; j < M; j++)
+    {
+        double a = 2.0 * 3.14159265358979323846 * (double)j / (double)M;
+        hole[j][0] = cx + _radius * std::cos(a);
+        hole[j][1] = cy + _radius * std::sin(a);
+    }
+    return makeHoledBox<M>(_min, _max, hole);
+}
+
+#endif // !_PRIMITIVES_H_
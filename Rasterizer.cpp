@@ -0,0 +1,480 @@
+#include "Rasterizer.h"
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTERIZER_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const uint32_t BACKGROUND_COLOR = 0xFF000000;  // 黑色背景，与线框模式一致
+const float AMBIENT = 0.2f;                      // 环境光
+const float LIGHT_DIR[3] = {0.3714f, 0.5571f, 0.7428f};  // 视空间中的平行光方向（已归一化）
+
+inline float shadeOf(float nx, float ny, float nz) {
+    float d = nx * LIGHT_DIR[0] + ny * LIGHT_DIR[1] + nz * LIGHT_DIR[2];
+    return AMBIENT + (1.0f - AMBIENT) * (d > 0 ? d : 0);
+}
+
+inline uint32_t packColor(float shade, uint8_t r, uint8_t g, uint8_t b) {
+    shade = std::min(std::max(shade, 0.0f), 1.0f);
+    return 0xFF000000u |
+           ((uint32_t)(r * shade + 0.5f) << 16) |
+           ((uint32_t)(g * shade + 0.5f) << 8) |
+           (uint32_t)(b * shade + 0.5f);
+}
+
+} // namespace
+
+SoftwareRasterizer::SoftwareRasterizer(unsigned _threads) {
+    set_thread_count(_threads);
+}
+
+SoftwareRasterizer::~SoftwareRasterizer() {
+    stop_workers();
+}
+
+void SoftwareRasterizer::set_thread_count(unsigned _threads) {
+    if (_threads == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        _threads = hw > 0 ? hw : 1;
+    }
+    if (_threads == threads_ && workers_.size() + 1 == threads_) return;
+    stop_workers();
+    threads_ = _threads;
+    start_workers();
+}
+
+void SoftwareRasterizer::start_workers() {
+    // 此时没有工作线程，轮次从0重新计数，新线程不会把上一批线程的最后一轮当成新任务
+    stop_ = false;
+    job_round_ = 0;
+    workers_.reserve(threads_ - 1);
+    for (unsigned w = 1; w < threads_; w++) {
+        workers_.emplace_back(&SoftwareRasterizer::worker_loop, this, w);
+    }
+}
+
+void SoftwareRasterizer::stop_workers() {
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+}
+
+void SoftwareRasterizer::worker_loop(unsigned _worker) {
+    unsigned long long seen = 0;
+    for (;;) {
+        const std::function<void(unsigned)>* job;
+        {
+            std::unique_lock<std::mutex> lock(worker_mutex_);
+            wake_cv_.wait(lock, [&] { return stop_ || job_round_ != seen; });
+            if (stop_) return;
+            seen = job_round_;
+            // 本轮不需要这个线程
+            if (_worker >= job_threads_) continue;
+            job = job_;
+        }
+        (*job)(_worker);
+        {
+            std::lock_guard<std::mutex> lock(worker_mutex_);
+            if (--job_pending_ == 0) done_cv_.notify_one();
+        }
+    }
+}
+
+void SoftwareRasterizer::run_workers(unsigned _threads, const std::function<void(unsigned)>& _fn) {
+    _threads = std::min<unsigned>(_threads, (unsigned)workers_.size() + 1);
+    if (_threads <= 1) {
+        _fn(0u);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        job_ = &_fn;
+        job_threads_ = _threads;
+        job_pending_ = _threads - 1;
+        job_round_++;
+    }
+    wake_cv_.notify_all();
+    _fn(0u);
+    std::unique_lock<std::mutex> lock(worker_mutex_);
+    done_cv_.wait(lock, [&] { return job_pending_ == 0; });
+    job_ = nullptr;
+}
+
+template <class Fn>
+void SoftwareRasterizer::parallel_range(size_t _count, Fn _fn) {
+    const size_t MIN_PER_THREAD = 4096;
+    unsigned threads = (unsigned)std::min<size_t>(threads_, std::max<size_t>(1, _count / MIN_PER_THREAD));
+    run_workers(threads, [&](unsigned w) {
+        size_t begin = _count * w / threads;
+        size_t end = _count * (w + 1) / threads;
+        _fn(begin, end, w);
+    });
+}
+
+void SoftwareRasterizer::resize(int _width, int _height) {
+    if (_width == width_ && _height == height_) return;
+    width_ = std::max(_width, 0);
+    height_ = std::max(_height, 0);
+    stride_ = (width_ + 3) & ~3;
+    tiles_x_ = (width_ + TILE_SIZE - 1) / TILE_SIZE;
+    tiles_y_ = (height_ + TILE_SIZE - 1) / TILE_SIZE;
+    color_.assign((size_t)stride_ * height_, BACKGROUND_COLOR);
+    depth_.assign((size_t)stride_ * height_, -FLT_MAX);
+    reset_scissor();
+}
+
+void SoftwareRasterizer::set_scissor(int _x0, int _y0, int _x1, int _y1) {
+    int x0 = std::max(_x0, 0), y0 = std::max(_y0, 0);
+    int x1 = std::min(_x1, width_), y1 = std::min(_y1, height_);
+    active_tiles_.clear();
+    if (x0 >= x1 || y0 >= y1) {
+        scissor_x0_ = scissor_y0_ = scissor_x1_ = scissor_y1_ = 0;
+        return;
+    }
+
+    // 扩展到分块边界，保证每个重绘的分块完整地是本帧的结果
+    int tx0 = x0 / TILE_SIZE, ty0 = y0 / TILE_SIZE;
+    int tx1 = (x1 - 1) / TILE_SIZE, ty1 = (y1 - 1) / TILE_SIZE;
+    scissor_x0_ = tx0 * TILE_SIZE;
+    scissor_y0_ = ty0 * TILE_SIZE;
+    scissor_x1_ = std::min((tx1 + 1) * TILE_SIZE, width_);
+    scissor_y1_ = std::min((ty1 + 1) * TILE_SIZE, height_);
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            active_tiles_.push_back(ty * tiles_x_ + tx);
+        }
+    }
+}
+
+size_t SoftwareRasterizer::memory_bytes() const {
+    size_t bytes = color_.capacity() * sizeof(uint32_t) + depth_.capacity() * sizeof(float) +
+                   active_tiles_.capacity() * sizeof(int);
+    bytes += (screen_x_.capacity() + screen_y_.capacity() + screen_z_.capacity() +
+              vertex_shade_.capacity() + face_shade_.capacity()) * sizeof(float);
+    bytes += bins_.capacity() * sizeof(std::vector<uint32_t>);
+    for (const auto& bin : bins_) bytes += bin.capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+void SoftwareRasterizer::render(const TriangleMesh& _mesh, const ViewParams& _view, ShadeMode _mode) {
+    if (width_ <= 0 || height_ <= 0 || active_tiles_.empty()) return;
+
+    transform_vertices(_mesh, _view, _mode);
+    bin_triangles(_mesh);
+
+    // 与裁剪区域相交的分块动态分配给各线程；分块内先清屏再光栅化，减少对整个缓冲的额外遍历
+    int tileCount = (int)active_tiles_.size();
+    std::atomic<int> nextTile(0);
+    run_workers(std::min<unsigned>(threads_, (unsigned)tileCount), [&](unsigned) {
+        int i;
+        while ((i = nextTile.fetch_add(1)) < tileCount) {
+            rasterize_tile(active_tiles_[i], _mesh, _mode);
+        }
+    });
+}
+
+void SoftwareRasterizer::render_line_strips(const std::vector<Point3D>& _positions, const EdgeStrips& _strips,
+                                            const ViewParams& _view) {
+    if (width_ <= 0 || height_ <= 0 || active_tiles_.empty()) return;
+
+    transform_positions(_positions, _view);
+    for (int y = scissor_y0_; y < scissor_y1_; y++) {
+        uint32_t* row = &color_[(size_t)y * stride_];
+        std::fill(row + scissor_x0_, row + scissor_x1_, BACKGROUND_COLOR);
+    }
+
+    // 沿折线前进，上一段的终点即下一段的起点，不再重新读取和变换
+    const uint32_t color = packColor(1.0f, base_r_, base_g_, base_b_);
+    for (size_t s = 0; s < _strips.stripCount(); s++) {
+        uint32_t begin = _strips.offsets[s], end = _strips.offsets[s + 1];
+        float ax = screen_x_[_strips.vertices[begin]], ay = screen_y_[_strips.vertices[begin]];
+        for (uint32_t k = begin + 1; k < end; k++) {
+            float bx = screen_x_[_strips.vertices[k]], by = screen_y_[_strips.vertices[k]];
+            rasterize_segment(ax, ay, bx, by, color);
+            ax = bx;
+            ay = by;
+        }
+    }
+}
+
+void SoftwareRasterizer::rasterize_segment(float _ax, float _ay, float _bx, float _by, uint32_t _color) {
+    // 按像素中心裁剪到裁剪区域（Liang-Barsky）
+    const float xmin = scissor_x0_ + 0.5f, xmax = scissor_x1_ - 0.5f;
+    const float ymin = scissor_y0_ + 0.5f, ymax = scissor_y1_ - 0.5f;
+    float dx = _bx - _ax, dy = _by - _ay;
+    float t0 = 0.0f, t1 = 1.0f;
+    const float p[4] = {-dx, dx, -dy, dy};
+    const float q[4] = {_ax - xmin, xmax - _ax, _ay - ymin, ymax - _ay};
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0.0f) {
+            if (q[i] < 0.0f) return;
+            continue;
+        }
+        float t = q[i] / p[i];
+        if (p[i] < 0.0f) {
+            if (t > t1) return;
+            t0 = std::max(t0, t);
+        } else {
+            if (t < t0) return;
+            t1 = std::min(t1, t);
+        }
+    }
+    float x = _ax + t0 * dx, y = _ay + t0 * dy;
+    float ex = _ax + t1 * dx, ey = _ay + t1 * dy;
+
+    // DDA：沿主方向每步一个像素
+    int steps = (int)std::ceil(std::max(std::fabs(ex - x), std::fabs(ey - y)));
+    float sx = steps > 0 ? (ex - x) / steps : 0.0f, sy = steps > 0 ? (ey - y) / steps : 0.0f;
+    for (int i = 0; i <= steps; i++) {
+        int px = std::min(std::max((int)x, scissor_x0_), scissor_x1_ - 1);
+        int py = std::min(std::max((int)y, scissor_y0_), scissor_y1_ - 1);
+        color_[(size_t)py * stride_ + px] = _color;
+        x += sx;
+        y += sy;
+    }
+}
+
+void SoftwareRasterizer::transform_positions(const std::vector<Point3D>& _positions, const ViewParams& _view) {
+    size_t n = _positions.size();
+    screen_x_.resize(n);
+    screen_y_.resize(n);
+    screen_z_.resize(n);
+
+    const float cx = std::cos(_view.rotationX), sx = std::sin(_view.rotationX);
+    const float cy = std::cos(_view.rotationY), sy = std::sin(_view.rotationY);
+    const float s = _view.scale * 100.0f;
+    const float ox = width_ / 2 + _view.translateX;
+    const float oy = height_ / 2 + _view.translateY;
+    const Point3D c = _view.center;
+
+    // 与 projectPoint 相同的变换：中心偏移 -> 绕X轴 -> 绕Y轴 -> 缩放平移（Y轴翻转）
+    parallel_range(n, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            const Point3D& p = _positions[i];
+            float x = p.x - c.x, y = p.y - c.y, z = p.z - c.z;
+            float y1 = y * cx - z * sx;
+            float z1 = y * sx + z * cx;
+            float x2 = x * cy + z1 * sy;
+            float z2 = -x * sy + z1 * cy;
+            screen_x_[i] = x2 * s + ox;
+            screen_y_[i] = -y1 * s + oy;
+            screen_z_[i] = z2;
+        }
+    });
+}
+
+void SoftwareRasterizer::transform_vertices(const TriangleMesh& _mesh, const ViewParams& _view, ShadeMode _mode) {
+    transform_positions(_mesh.positions, _view);
+    size_t n = _mesh.positions.size();
+    const float cx = std::cos(_view.rotationX), sx = std::sin(_view.rotationX);
+    const float cy = std::cos(_view.rotationY), sy = std::sin(_view.rotationY);
+
+    // 法向只需旋转；光源固定在视空间中
+    auto rotatedShade = [&](const Point3D& nrm) {
+        float y1 = nrm.y * cx - nrm.z * sx;
+        float z1 = nrm.y * sx + nrm.z * cx;
+        float x2 = nrm.x * cy + z1 * sy;
+        float z2 = -nrm.x * sy + z1 * cy;
+        return shadeOf(x2, y1, z2);
+    };
+
+    if (_mode == SHADE_GOURAUD) {
+        vertex_shade_.resize(n);
+        parallel_range(n, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; i++) {
+                vertex_shade_[i] = rotatedShade(_mesh.vertexNormals[i]);
+            }
+        });
+    } else {
+        size_t faces = _mesh.faceNormals.size();
+        face_shade_.resize(faces);
+        parallel_range(faces, [&](size_t begin, size_t end, unsigned) {
+            for (size_t f = begin; f < end; f++) {
+                face_shade_[f] = rotatedShade(_mesh.faceNormals[f]);
+            }
+        });
+    }
+}
+
+void SoftwareRasterizer::bin_triangles(const TriangleMesh& _mesh) {
+    int tileCount = tiles_x_ * tiles_y_;
+    size_t triCount = _mesh.triangleCount();
+    unsigned threads = (unsigned)std::min<size_t>(threads_, std::max<size_t>(1, triCount / 4096));
+
+    bins_.resize((size_t)threads_ * tileCount);
+    for (auto& bin : bins_) bin.clear();
+
+    run_workers(threads, [&](unsigned w) {
+        size_t begin = triCount * w / threads;
+        size_t end = triCount * (w + 1) / threads;
+        std::vector<uint32_t>* bins = &bins_[(size_t)w * tileCount];
+
+        for (size_t t = begin; t < end; t++) {
+            uint32_t i0 = _mesh.indices[t * 3], i1 = _mesh.indices[t * 3 + 1], i2 = _mesh.indices[t * 3 + 2];
+            float x0 = screen_x_[i0], y0 = screen_y_[i0];
+            float x1 = screen_x_[i1], y1 = screen_y_[i1];
+            float x2 = screen_x_[i2], y2 = screen_y_[i2];
+
+            // 屏幕Y轴向下，正面（视空间逆时针）三角形的有向面积为负
+            float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+            if (area == 0 || (cull_backfaces_ && area > 0)) continue;
+
+            // 包围盒先裁剪到裁剪区域，区域外的分块不会被光栅化，无需装箱
+            int minX = std::max(scissor_x0_, (int)std::floor(std::min(x0, std::min(x1, x2))));
+            int maxX = std::min(scissor_x1_ - 1, (int)std::ceil(std::max(x0, std::max(x1, x2))));
+            int minY = std::max(scissor_y0_, (int)std::floor(std::min(y0, std::min(y1, y2))));
+            int maxY = std::min(scissor_y1_ - 1, (int)std::ceil(std::max(y0, std::max(y1, y2))));
+            if (minX > maxX || minY > maxY) continue;
+
+            for (int ty = minY / TILE_SIZE; ty <= maxY / TILE_SIZE; ty++) {
+                for (int tx = minX / TILE_SIZE; tx <= maxX / TILE_SIZE; tx++) {
+                    bins[ty * tiles_x_ + tx].push_back((uint32_t)t);
+                }
+            }
+        }
+    });
+}
+
+void SoftwareRasterizer::rasterize_tile(int _tile, const TriangleMesh& _mesh, ShadeMode _mode) {
+    const int tileX = (_tile % tiles_x_) * TILE_SIZE;
+    const int tileY = (_tile / tiles_x_) * TILE_SIZE;
+    const int tileX1 = std::min(tileX + TILE_SIZE, stride_);
+    const int tileY1 = std::min(tileY + TILE_SIZE, height_);
+
+    for (int y = tileY; y < tileY1; y++) {
+        std::fill(&color_[(size_t)y * stride_ + tileX], &color_[(size_t)y * stride_ + tileX1], BACKGROUND_COLOR);
+        std::fill(&depth_[(size_t)y * stride_ + tileX], &depth_[(size_t)y * stride_ + tileX1], -FLT_MAX);
+    }
+
+    const int tileCount = tiles_x_ * tiles_y_;
+    for (unsigned w = 0; w < threads_; w++) {
+        const std::vector<uint32_t>& bin = bins_[(size_t)w * tileCount + _tile];
+        for (uint32_t t : bin) {
+            uint32_t i0 = _mesh.indices[t * 3], i1 = _mesh.indices[t * 3 + 1], i2 = _mesh.indices[t * 3 + 2];
+            float x0 = screen_x_[i0], y0 = screen_y_[i0], z0 = screen_z_[i0];
+            float x1 = screen_x_[i1], y1 = screen_y_[i1], z1 = screen_z_[i1];
+            float x2 = screen_x_[i2], y2 = screen_y_[i2], z2 = screen_z_[i2];
+            float s0 = 0, s1 = 0, s2 = 0;
+            if (_mode == SHADE_GOURAUD) {
+                s0 = vertex_shade_[i0];
+                s1 = vertex_shade_[i1];
+                s2 = vertex_shade_[i2];
+            }
+
+            // 统一为正面积，使三角形内部的三个边函数均非负
+            float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+            if (area < 0) {
+                std::swap(x1, x2);
+                std::swap(y1, y2);
+                std::swap(z1, z2);
+                std::swap(s1, s2);
+                area = -area;
+            }
+            float invArea = 1.0f / area;
+
+            int minX = std::max(tileX, (int)std::floor(std::min(x0, std::min(x1, x2))));
+            int maxX = std::min(std::min(tileX1, width_) - 1, (int)std::ceil(std::max(x0, std::max(x1, x2))));
+            int minY = std::max(tileY, (int)std::floor(std::min(y0, std::min(y1, y2))));
+            int maxY = std::min(tileY1 - 1, (int)std::ceil(std::max(y0, std::max(y1, y2))));
+            if (minX > maxX || minY > maxY) continue;
+            minX &= ~3;
+
+            // 边函数 E(p) = A*px + B*py + C，E0 对应顶点0的重心坐标
+            float a0 = y1 - y2, b0 = x2 - x1, c0 = x1 * y2 - y1 * x2;
+            float a1 = y2 - y0, b1 = x0 - x2, c1 = x2 * y0 - y2 * x0;
+            float a2 = y0 - y1, b2 = x1 - x0, c2 = x0 * y1 - y0 * x1;
+
+            // 深度与亮度都是屏幕空间的线性函数
+            float za = (a0 * z0 + a1 * z1 + a2 * z2) * invArea;
+            float zb = (b0 * z0 + b1 * z1 + b2 * z2) * invArea;
+            float zc = (c0 * z0 + c1 * z1 + c2 * z2) * invArea;
+            float sa = (a0 * s0 + a1 * s1 + a2 * s2) * invArea;
+            float sb = (b0 * s0 + b1 * s1 + b2 * s2) * invArea;
+            float sc = (c0 * s0 + c1 * s1 + c2 * s2) * invArea;
+            uint32_t flatColor = _mode == SHADE_FLAT
+                ? packColor(face_shade_[_mesh.triangleFaces[t]], base_r_, base_g_, base_b_) : 0;
+
+#ifdef RASTERIZER_USE_SSE2
+            const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 step0 = _mm_set1_ps(a0 * 4), step1 = _mm_set1_ps(a1 * 4), step2 = _mm_set1_ps(a2 * 4);
+            const __m128 stepZ = _mm_set1_ps(za * 4), stepS = _mm_set1_ps(sa * 4);
+            const __m128 baseR = _mm_set1_ps(base_r_), baseG = _mm_set1_ps(base_g_), baseB = _mm_set1_ps(base_b_);
+            const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+            const __m128i flat = _mm_set1_epi32((int)flatColor);
+
+            for (int y = minY; y <= maxY; y++) {
+                float py = y + 0.5f;
+                __m128 px = _mm_add_ps(_mm_set1_ps((float)minX), laneOffset);
+                __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a0), px), _mm_set1_ps(b0 * py + c0));
+                __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a1), px), _mm_set1_ps(b1 * py + c1));
+                __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a2), px), _mm_set1_ps(b2 * py + c2));
+                __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(za), px), _mm_set1_ps(zb * py + zc));
+                __m128 sh = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sa), px), _mm_set1_ps(sb * py + sc));
+
+                float* depthRow = &depth_[(size_t)y * stride_];
+                uint32_t* colorRow = &color_[(size_t)y * stride_];
+                for (int x = minX; x <= maxX; x += 4) {
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                               _mm_cmpge_ps(e2, zero));
+                    if (_mm_movemask_ps(inside)) {
+                        __m128 oldZ = _mm_loadu_ps(depthRow + x);
+                        __m128 mask = _mm_and_ps(inside, _mm_cmpgt_ps(z, oldZ));
+                        if (_mm_movemask_ps(mask)) {
+                            _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, oldZ)));
+
+                            __m128i c;
+                            if (_mode == SHADE_GOURAUD) {
+                                __m128 s = _mm_min_ps(_mm_max_ps(sh, zero), one);
+                                __m128i r = _mm_cvtps_epi32(_mm_mul_ps(s, baseR));
+                                __m128i g = _mm_cvtps_epi32(_mm_mul_ps(s, baseG));
+                                __m128i b = _mm_cvtps_epi32(_mm_mul_ps(s, baseB));
+                                c = _mm_or_si128(_mm_or_si128(alpha, _mm_slli_epi32(r, 16)),
+                                                 _mm_or_si128(_mm_slli_epi32(g, 8), b));
+                            } else {
+                                c = flat;
+                            }
+                            __m128i m = _mm_castps_si128(mask);
+                            __m128i oldC = _mm_loadu_si128((const __m128i*)(colorRow + x));
+                            _mm_storeu_si128((__m128i*)(colorRow + x),
+                                             _mm_or_si128(_mm_and_si128(m, c), _mm_andnot_si128(m, oldC)));
+                        }
+                    }
+                    e0 = _mm_add_ps(e0, step0);
+                    e1 = _mm_add_ps(e1, step1);
+                    e2 = _mm_add_ps(e2, step2);
+                    z = _mm_add_ps(z, stepZ);
+                    sh = _mm_add_ps(sh, stepS);
+                }
+            }
+#else
+            for (int y = minY; y <= maxY; y++) {
+                float py = y + 0.5f;
+                float* depthRow = &depth_[(size_t)y * stride_];
+                uint32_t* colorRow = &color_[(size_t)y * stride_];
+                for (int x = minX; x <= maxX; x++) {
+                    float px = x + 0.5f;
+                    if (a0 * px + b0 * py + c0 < 0 || a1 * px + b1 * py + c1 < 0 || a2 * px + b2 * py + c2 < 0) continue;
+                    float z = za * px + zb * py + zc;
+                    if (z <= depthRow[x]) continue;
+                    depthRow[x] = z;
+                    colorRow[x] = _mode == SHADE_GOURAUD
+                        ? packColor(sa * px + sb * py + sc, base_r_, base_g_, base_b_) : flatColor;
+                }
+            }
+#endif
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef _RASTERIZER_H_
+#define _RASTERIZER_H_
+
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "EdgeStrips.h"
+#include "Rendering.h"
+#include "Tessellation.h"
+
+// 着色模式
+enum ShadeMode {
+    SHADE_FLAT,     // 平面着色：每个面一个亮度
+    SHADE_GOURAUD   // Gouraud着色：顶点亮度在三角形内插值
+};
+
+// CPU三角形光栅化器
+// 流程：顶点变换 -> 背面剔除并按屏幕分块装箱 -> 各分块并行光栅化
+// 光栅化使用边函数判断覆盖，每次用SIMD处理一行中相邻的4个像素，并做深度测试
+// 颜色缓冲为32位BGRA，可直接交给 SetDIBitsToDevice 输出
+// 并行的各步由常驻的工作线程执行：构造时创建，空闲时在条件变量上等待，析构时结束，每帧不再创建线程
+class SoftwareRasterizer
+{
+public:
+    static const int TILE_SIZE = 64;  // 分块边长（像素）
+
+    // _threads 为0时使用硬件线程数；调用 render 的线程也参与计算，另建 _threads - 1 个工作线程
+    explicit SoftwareRasterizer(unsigned _threads = 0);
+    ~SoftwareRasterizer();
+
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    // 调整帧缓冲大小，行跨度向上对齐到4个像素以便SIMD写入；尺寸改变时裁剪区域恢复为整个帧缓冲
+    void resize(int _width, int _height);
+
+    // 只重绘与裁剪区域 [_x0, _x1) x [_y0, _y1) 相交的分块，其余分块保留上一帧的内容（不清屏）
+    // 裁剪区域外的像素在上一帧和本帧都为背景时（例如区域覆盖了两帧模型的屏幕范围），结果与整帧渲染相同
+    void set_scissor(int _x0, int _y0, int _x1, int _y1);
+    void reset_scissor() { set_scissor(0, 0, width_, height_); }
+
+    // 渲染一帧
+    void render(const TriangleMesh& _mesh, const ViewParams& _view, ShadeMode _mode);
+
+    // 以基础颜色绘制一帧线框：_positions 按顶点下标排列（如 TriangleMesh::positions），_strips 为全部边串成的折线
+    // 每个顶点只变换一次，折线上相邻两段共享端点；不做深度测试，裁剪区域内先清为背景色
+    void render_line_strips(const std::vector<Point3D>& _positions, const EdgeStrips& _strips, const ViewParams& _view);
+
+    const uint32_t* pixels() const { return color_.data(); }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int stride() const { return stride_; }
+
+    void set_cull_backfaces(bool _cull) { cull_backfaces_ = _cull; }
+    void set_base_color(uint8_t _r, uint8_t _g, uint8_t _b) { base_r_ = _r; base_g_ = _g; base_b_ = _b; }
+    // 结束现有的工作线程并按新的线程数重建；_threads 为0时使用硬件线程数
+    void set_thread_count(unsigned _threads);
+
+    // 帧缓冲、每帧顶点变换结果和分块装箱结果已分配的字节数
+    size_t memory_bytes() const;
+
+private:
+    void start_workers();
+    void stop_workers();
+    void worker_loop(unsigned _worker);
+    // 调用线程作为0号线程，与 _threads - 1 个工作线程各执行一次 _fn(worker)，全部完成后返回
+    void run_workers(unsigned _threads, const std::function<void(unsigned)>& _fn);
+    // 将 [0, _count) 均分给各线程执行 _fn(begin, end, worker)，数量少时减少线程数
+    template <class Fn>
+    void parallel_range(size_t _count, Fn _fn);
+
+    void transform_positions(const std::vector<Point3D>& _positions, const ViewParams& _view);
+    void transform_vertices(const TriangleMesh& _mesh, const ViewParams& _view, ShadeMode _mode);
+    void rasterize_segment(float _ax, float _ay, float _bx, float _by, uint32_t _color);
+    void bin_triangles(const TriangleMesh& _mesh);
+    void rasterize_tile(int _tile, const TriangleMesh& _mesh, ShadeMode _mode);
+
+    int width_ = 0;
+    int height_ = 0;
+    int stride_ = 0;
+    int tiles_x_ = 0;
+    int tiles_y_ = 0;
+    int scissor_x0_ = 0, scissor_y0_ = 0;   // 裁剪区域扩展到分块边界后的范围（像素，右下为开区间）
+    int scissor_x1_ = 0, scissor_y1_ = 0;
+    unsigned threads_ = 1;
+    bool cull_backfaces_ = true;
+    uint8_t base_r_ = 220, base_g_ = 40, base_b_ = 40;
+
+    std::vector<uint32_t> color_;   // 颜色缓冲
+    std::vector<float> depth_;      // 深度缓冲，值越大离观察者越近
+
+    // 每帧的顶点变换结果（SoA布局）
+    std::vector<float> screen_x_;
+    std::vector<float> screen_y_;
+    std::vector<float> screen_z_;
+    std::vector<float> vertex_shade_;  // 顶点亮度（Gouraud）
+    std::vector<float> face_shade_;    // 面亮度（平面着色）
+
+    // 分块装箱结果：bins_[线程 * 分块数 + 分块] 为该线程落入该分块的三角形
+    std::vector<std::vector<uint32_t>> bins_;
+    std::vector<int> active_tiles_;  // 与裁剪区域相交的分块
+
+    // 常驻工作线程（threads_ - 1 个）及一轮任务的分发状态
+    std::vector<std::thread> workers_;
+    std::mutex worker_mutex_;
+    std::condition_variable wake_cv_;   // 有新一轮任务或需要退出
+    std::condition_variable done_cv_;   // 本轮任务全部完成
+    const std::function<void(unsigned)>* job_ = nullptr;
+    unsigned job_threads_ = 0;          // 本轮参与的线程数（含调用线程）
+    unsigned job_pending_ = 0;          // 本轮尚未完成的工作线程数
+    unsigned long long job_round_ = 0;  // 轮次，工作线程据此识别新一轮任务
+    bool stop_ = false;
+};
+
+#endif // !_RASTERIZER_H_
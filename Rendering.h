@@ -0,0 +1,26 @@
+#ifndef _RENDERING_H_
+#define _RENDERING_H_
+
+// 渲染相关结构 - 3D点的表示
+typedef struct {
+    float x, y, z;
+} Point3D;
+
+// 渲染相关结构 - 3D线段的表示
+typedef struct {
+    Point3D start;  // 线段起点
+    Point3D end;    // 线段终点
+} LineSegment3D;
+
+// 视图参数 - 与交互状态一一对应，描述模型到屏幕的变换
+// 变换顺序与 projectPoint 一致：中心偏移 -> 绕X轴旋转 -> 绕Y轴旋转 -> 缩放平移
+typedef struct {
+    Point3D center;     // 模型中心点
+    float rotationX;    // 绕X轴的旋转角度（弧度）
+    float rotationY;    // 绕Y轴的旋转角度（弧度）
+    float scale;        // 缩放比例
+    float translateX;   // X轴平移量（屏幕坐标）
+    float translateY;   // Y轴平移量（屏幕坐标）
+} ViewParams;
+
+#endif // !_RENDERING_H_
@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include "BodyArena.h"
 
 
 struct Point;
@@ -54,6 +56,7 @@ typedef struct Vertex
 {
 	Point     p_;            // ���㼸��λ��
 	Halfedge* he_ = nullptr; // �붥����ص�һ�����
+	int       id_ = -1;      // 顶点在 Body::vertices_ 中的下标
 }Vertex;
 
 typedef struct Halfedge
@@ -93,23 +96,22 @@ typedef struct Body
 {
 	Face* first_face_ = nullptr; // ��һ�� Face 
 	std::vector<Edge*> edges_;   // ��¼���еıߣ������߿���ʾ	
+	std::vector<Vertex*> vertices_; // 记录所有的顶点，下标即 Vertex::id_
 	int face_num_ = 0;           // ��ĸ���
 	int edge_num_ = 0;           // ����
 	int vertex_num_ = 0;         // ������
+	BodyArena arena_;            // 本体独享的内存池，所有拓扑记录都从这里分配
+	unsigned long long revision_ = 0; // 每次欧拉操作后递增，用于判断快照是否过期
+	const unsigned long long id_ = next_id(); // 进程内唯一的编号，地址被新实体复用时也不会重复
 
 	/** ɾ����¼�ı� */
-	void delete_edge(Edge* _e)
+	bool delete_edge(Edge* _e)
 	{
 		auto it = std::find(edges_.begin(), edges_.end(), _e);
-		if (it != edges_.end())
-		{
-			if (*it)
-			{
-				delete* it;
-				*it = nullptr;
-			}
-			edges_.erase(it);
-		}
+		if (it == edges_.end()) return false;
+		arena_.destroy(*it);
+		edges_.erase(it);
+		return true;
 	}
 
 
@@ -121,16 +123,46 @@ typedef struct Body
 
 	~Body()
 	{
-		// 清理所有边
-		for (auto edge : edges_)
-		{
-			if (edge)
-			{
-				delete edge;
-				edge = nullptr;
-			}
-		}
+		// 所有拓扑记录都分配在 arena_ 中，随其一并释放
 		edges_.clear();
+		vertices_.clear();
+	}
+
+	Body(const Body&) = delete;
+	Body& operator=(const Body&) = delete;
+
+	static unsigned long long next_id()
+	{
+		static std::atomic<unsigned long long> counter{0};
+		return ++counter;
+	}
+
+	/** 在本体的内存池中创建并登记一个顶点 */
+	Vertex* create_vertex(const Point& _p)
+	{
+		Vertex* v = arena_.create<Vertex>(_p);
+		add_vertex(v);
+		return v;
+	}
+
+	/** 按预计创建的记录数预留顶点表、边表和内存池，批量构建时避免反复扩容 */
+	void reserve(size_t _vertices, size_t _edges, size_t _faces, size_t _loops)
+	{
+		vertices_.reserve(_vertices);
+		edges_.reserve(_edges);
+		auto bytes = [](size_t _size) { return (_size + 7) & ~(size_t)7; };
+		arena_.reserve(_vertices * bytes(sizeof(Vertex)) +
+		               _edges * (bytes(sizeof(Edge)) + 2 * bytes(sizeof(Halfedge))) +
+		               _faces * bytes(sizeof(Face)) +
+		               _loops * bytes(sizeof(Loop)));
+	}
+
+	/** 登记新顶点，分配其下标 */
+	void add_vertex(Vertex* _v)
+	{
+		_v->id_ = (int)vertices_.size();
+		vertices_.push_back(_v);
+		vertex_num_++;
 	}
 
 }Body;
@@ -0,0 +1,423 @@
+#include "Tessellation.h"
+#include "Topology.h"
+#include "ParallelFaces.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// 二维多边形，顶点同时记录其在实体中的 id
+struct Polygon2D {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<uint32_t> id;
+
+    size_t size() const { return id.size(); }
+    void push(double _x, double _y, uint32_t _id) { x.push_back(_x); y.push_back(_y); id.push_back(_id); }
+};
+
+// 二维叉积 (b-a)x(c-a)，大于0表示 a->b->c 为逆时针
+inline double cross2(double ax, double ay, double bx, double by, double cx, double cy) {
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+double signedArea(const Polygon2D& poly) {
+    double area = 0;
+    size_t n = poly.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        area += poly.x[j] * poly.y[i] - poly.x[i] * poly.y[j];
+    }
+    return area * 0.5;
+}
+
+void reversePolygon(Polygon2D& poly) {
+    std::reverse(poly.x.begin(), poly.x.end());
+    std::reverse(poly.y.begin(), poly.y.end());
+    std::reverse(poly.id.begin(), poly.id.end());
+}
+
+// 点是否严格位于逆时针三角形内部（边界上的点视为在外部，避免桥接产生的重复顶点误判）
+inline bool insideTriangle(double px, double py,
+                           double ax, double ay, double bx, double by, double cx, double cy) {
+    return cross2(ax, ay, bx, by, px, py) > 0 &&
+           cross2(bx, by, cx, cy, px, py) > 0 &&
+           cross2(cx, cy, ax, ay, px, py) > 0;
+}
+
+// 将内环通过一条桥边并入外环（Eberly 的可见点方法）
+// 外环为逆时针，内环为顺时针
+bool bridgeHole(Polygon2D& outer, const Polygon2D& hole) {
+    // 内环上x最大的顶点M
+    size_t m = 0;
+    for (size_t i = 1; i < hole.size(); i++) {
+        if (hole.x[i] > hole.x[m]) m = i;
+    }
+    double mx = hole.x[m], my = hole.y[m];
+
+    // 从M向+x方向发射射线，找最近的外环交边
+    size_t n = outer.size();
+    double bestX = INFINITY;
+    size_t bestEdge = n;
+    for (size_t i = 0; i < n; i++) {
+        size_t j = (i + 1) % n;
+        double y0 = outer.y[i], y1 = outer.y[j];
+        if ((y0 > my) == (y1 > my) && y0 != my && y1 != my) continue;
+        if (y0 == y1) continue;
+        double t = (my - y0) / (y1 - y0);
+        if (t < 0 || t > 1) continue;
+        double ix = outer.x[i] + t * (outer.x[j] - outer.x[i]);
+        if (ix >= mx && ix < bestX) {
+            bestX = ix;
+            bestEdge = i;
+        }
+    }
+    if (bestEdge == n) return false;
+
+    // 取交边上x较大的端点作为候选可见点P
+    size_t i0 = bestEdge, i1 = (bestEdge + 1) % n;
+    size_t p = outer.x[i0] > outer.x[i1] ? i0 : i1;
+
+    // 若三角形 M-I-P 内有外环的凹点，则改取其中与射线夹角最小的凹点
+    double ix = bestX, iy = my;
+    double px = outer.x[p], py = outer.y[p];
+    double bestTan = INFINITY;
+    for (size_t i = 0; i < n; i++) {
+        if (i == p) continue;
+        size_t prev = (i + n - 1) % n, next = (i + 1) % n;
+        bool reflex = cross2(outer.x[prev], outer.y[prev], outer.x[i], outer.y[i],
+                             outer.x[next], outer.y[next]) <= 0;
+        if (!reflex) continue;
+        double qx = outer.x[i], qy = outer.y[i];
+        // 三角形 M-I-P 的绕向取决于P在射线的哪一侧
+        bool inside = py < my ? insideTriangle(qx, qy, mx, my, px, py, ix, iy)
+                              : insideTriangle(qx, qy, mx, my, ix, iy, px, py);
+        if (!inside) continue;
+        double tanAngle = std::fabs(qy - my) / std::max(qx - mx, 1e-300);
+        if (tanAngle < bestTan) {
+            bestTan = tanAngle;
+            p = i;
+        }
+    }
+
+    // 拼接：outer[0..p], hole[m..], hole[..m], outer[p..]
+    Polygon2D merged;
+    merged.x.reserve(n + hole.size() + 2);
+    merged.y.reserve(n + hole.size() + 2);
+    merged.id.reserve(n + hole.size() + 2);
+    for (size_t i = 0; i <= p; i++) merged.push(outer.x[i], outer.y[i], outer.id[i]);
+    for (size_t k = 0; k <= hole.size(); k++) {
+        size_t h = (m + k) % hole.size();
+        merged.push(hole.x[h], hole.y[h], hole.id[h]);
+    }
+    for (size_t i = p; i < n; i++) merged.push(outer.x[i], outer.y[i], outer.id[i]);
+    outer = merged;
+    return true;
+}
+
+// 对逆时针简单多边形做耳切三角化
+int earClip(const Polygon2D& poly, std::vector<uint32_t>& out) {
+    size_t n = poly.size();
+    if (n < 3) return 0;
+
+    std::vector<size_t> prev(n), next(n);
+    for (size_t i = 0; i < n; i++) {
+        prev[i] = (i + n - 1) % n;
+        next[i] = (i + 1) % n;
+    }
+
+    int triangles = 0;
+    size_t remaining = n;
+    size_t cur = 0;
+    size_t sinceLastEar = 0;
+    while (remaining > 3) {
+        size_t a = prev[cur], b = cur, c = next[cur];
+        double ax = poly.x[a], ay = poly.y[a];
+        double bx = poly.x[b], by = poly.y[b];
+        double cx = poly.x[c], cy = poly.y[c];
+
+        bool isEar = cross2(ax, ay, bx, by, cx, cy) > 0;
+        if (isEar) {
+            // 其余顶点都不能落在候选耳内部
+            for (size_t v = next[c]; v != a; v = next[v]) {
+                if (insideTriangle(poly.x[v], poly.y[v], ax, ay, bx, by, cx, cy)) {
+                    isEar = false;
+                    break;
+                }
+            }
+        }
+
+        // 一整圈都找不到耳时（退化或自交），强制切掉当前顶点，保证算法终止
+        if (isEar || sinceLastEar > remaining) {
+            out.push_back(poly.id[a]);
+            out.push_back(poly.id[b]);
+            out.push_back(poly.id[c]);
+            triangles++;
+            next[a] = c;
+            prev[c] = a;
+            remaining--;
+            sinceLastEar = 0;
+            cur = c;
+        } else {
+            sinceLastEar++;
+            cur = c;
+        }
+    }
+
+    size_t a = prev[cur], c = next[cur];
+    out.push_back(poly.id[a]);
+    out.push_back(poly.id[cur]);
+    out.push_back(poly.id[c]);
+    return triangles + 1;
+}
+
+inline Point3D normalized(double x, double y, double z) {
+    double len = std::sqrt(x * x + y * y + z * z);
+    if (len <= 0) return Point3D{0.0f, 0.0f, 0.0f};
+    return Point3D{(float)(x / len), (float)(y / len), (float)(z / len)};
+}
+
+} // namespace
+
+Point3D loopNormal(const Loop* loop) {
+    double nx = 0, ny = 0, nz = 0;
+    for (Halfedge* he : halfedges(loop)) {
+        const Point& a = he->start_vertex_->p_;
+        const Point& b = he->to_vertex_->p_;
+        nx += (a[1] - b[1]) * (a[2] + b[2]);
+        ny += (a[2] - b[2]) * (a[0] + b[0]);
+        nz += (a[0] - b[0]) * (a[1] + b[1]);
+    }
+
+    return Point3D{(float)nx, (float)ny, (float)nz};
+}
+
+namespace {
+
+// 面积最大的环为外环，其法向即面法向；返回外环，normal 为未归一化的法向
+const Loop* findOuterLoop(const Face* face, Point3D& normal, double& lengthSq, int& loopCount) {
+    const Loop* outerLoop = nullptr;
+    normal = Point3D{0.0f, 0.0f, 0.0f};
+    lengthSq = -1;
+    loopCount = 0;
+    for (const Loop* loop : loops(face)) {
+        Point3D n = loopNormal(loop);
+        double len = (double)n.x * n.x + (double)n.y * n.y + (double)n.z * n.z;
+        if (len > lengthSq) {
+            lengthSq = len;
+            normal = n;
+            outerLoop = loop;
+        }
+        loopCount++;
+    }
+    return outerLoop;
+}
+
+} // namespace
+
+Point3D faceNormal(const Face* face) {
+    if (!face) return Point3D{0.0f, 0.0f, 0.0f};
+    Point3D normal;
+    double lengthSq;
+    int loopCount;
+    findOuterLoop(face, normal, lengthSq, loopCount);
+    return normalized(normal.x, normal.y, normal.z);
+}
+
+int tessellateFace(const Face* face, std::vector<uint32_t>& outIndices, Point3D* outNormal) {
+    if (!face || !face->first_loop_) return 0;
+
+    Point3D normal;
+    double bestLen;
+    int loopCount;
+    const Loop* outerLoop = findOuterLoop(face, normal, bestLen, loopCount);
+    if (outNormal) *outNormal = normalized(normal.x, normal.y, normal.z);
+    if (!outerLoop || bestLen <= 0) return 0;
+
+    // 投影平面：丢弃法向绝对值最大的分量，并保证外环在二维中为逆时针
+    int k = 2;
+    if (std::fabs(normal.x) >= std::fabs(normal.y) && std::fabs(normal.x) >= std::fabs(normal.z)) k = 0;
+    else if (std::fabs(normal.y) >= std::fabs(normal.z)) k = 1;
+    int u = (k + 1) % 3, v = (k + 2) % 3;
+    float nk = k == 0 ? normal.x : (k == 1 ? normal.y : normal.z);
+    if (nk < 0) std::swap(u, v);
+
+    auto project = [u, v](const Loop* loop, Polygon2D& poly) {
+        for (const Vertex* vert : loopVertices(loop)) {
+            poly.push(vert->p_[u], vert->p_[v], (uint32_t)vert->id_);
+        }
+    };
+
+    Polygon2D outer;
+    project(outerLoop, outer);
+
+    // 常见情形：单环凸多边形，直接扇形三角化
+    if (loopCount == 1) {
+        size_t n = outer.size();
+        bool convex = true;
+        for (size_t i = 0; i < n && convex; i++) {
+            size_t a = (i + n - 1) % n, c = (i + 1) % n;
+            convex = cross2(outer.x[a], outer.y[a], outer.x[i], outer.y[i], outer.x[c], outer.y[c]) >= 0;
+        }
+        if (convex) {
+            for (size_t i = 1; i + 1 < n; i++) {
+                outIndices.push_back(outer.id[0]);
+                outIndices.push_back(outer.id[i]);
+                outIndices.push_back(outer.id[i + 1]);
+            }
+            return n >= 3 ? (int)(n - 2) : 0;
+        }
+        return earClip(outer, outIndices);
+    }
+
+    // 内环按x最大值从大到小依次桥接到外环上
+    std::vector<Polygon2D> holes;
+    for (const Loop* loop : loops(face)) {
+        if (loop == outerLoop || !loop->start_he_) continue;
+        holes.emplace_back();
+        project(loop, holes.back());
+        if (signedArea(holes.back()) > 0) reversePolygon(holes.back());
+    }
+    std::sort(holes.begin(), holes.end(), [](const Polygon2D& a, const Polygon2D& b) {
+        return *std::max_element(a.x.begin(), a.x.end()) > *std::max_element(b.x.begin(), b.x.end());
+    });
+    for (const Polygon2D& hole : holes) {
+        bridgeHole(outer, hole);
+    }
+
+    return earClip(outer, outIndices);
+}
+
+namespace {
+
+// 三角形 (a, b, c) 与原点构成的有向体积的6倍
+inline double signedVolume6(const Body* body, const uint32_t* tri) {
+    const Point& a = body->vertices_[tri[0]]->p_;
+    const Point& b = body->vertices_[tri[1]]->p_;
+    const Point& c = body->vertices_[tri[2]]->p_;
+    return a[0] * (b[1] * c[2] - b[2] * c[1])
+         - a[1] * (b[0] * c[2] - b[2] * c[0])
+         + a[2] * (b[0] * c[1] - b[1] * c[0]);
+}
+
+void fillPositions(const Body* body, TriangleMesh& mesh) {
+    mesh.positions.resize(body->vertices_.size());
+    for (size_t i = 0; i < body->vertices_.size(); i++) {
+        const Point& p = body->vertices_[i]->p_;
+        mesh.positions[i] = Point3D{(float)p[0], (float)p[1], (float)p[2]};
+    }
+}
+
+// 三角化之后的公共步骤：按有向体积统一朝向，再计算顶点法向
+void finishMesh(TriangleMesh& mesh, double volume) {
+    if (volume < 0) {
+        for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+            std::swap(mesh.indices[t + 1], mesh.indices[t + 2]);
+        }
+        for (Point3D& n : mesh.faceNormals) {
+            n.x = -n.x;
+            n.y = -n.y;
+            n.z = -n.z;
+        }
+    }
+
+    // 顶点法向：相邻三角形法向按面积加权累加后归一化
+    std::vector<double> accum(mesh.positions.size() * 3, 0.0);
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+        uint32_t i0 = mesh.indices[t], i1 = mesh.indices[t + 1], i2 = mesh.indices[t + 2];
+        const Point3D& a = mesh.positions[i0];
+        const Point3D& b = mesh.positions[i1];
+        const Point3D& c = mesh.positions[i2];
+        double ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+        double vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+        double nx = uy * vz - uz * vy, ny = uz * vx - ux * vz, nz = ux * vy - uy * vx;
+        for (uint32_t idx : {i0, i1, i2}) {
+            accum[idx * 3] += nx;
+            accum[idx * 3 + 1] += ny;
+            accum[idx * 3 + 2] += nz;
+        }
+    }
+    mesh.vertexNormals.resize(mesh.positions.size());
+    for (size_t i = 0; i < mesh.positions.size(); i++) {
+        mesh.vertexNormals[i] = normalized(accum[i * 3], accum[i * 3 + 1], accum[i * 3 + 2]);
+    }
+}
+
+// 一个面块的三角化结果，triangleCounts 为块内每个面的三角形数
+struct ChunkMesh {
+    std::vector<uint32_t> indices;
+    std::vector<Point3D> faceNormals;
+    std::vector<int> triangleCounts;
+    double volume = 0;
+};
+
+} // namespace
+
+void tessellateBody(const Body* body, TriangleMesh& mesh) {
+    mesh.clear();
+    if (!body) return;
+
+    fillPositions(body, mesh);
+
+    // 逐面三角化，同时累计有向体积以判断环的整体朝向
+    double volume = 0;
+    for (const Face* face : faces(body)) {
+        Point3D normal;
+        size_t first = mesh.indices.size();
+        int count = tessellateFace(face, mesh.indices, &normal);
+        uint32_t faceIndex = (uint32_t)mesh.faceNormals.size();
+        mesh.faceNormals.push_back(normal);
+        mesh.triangleFaces.insert(mesh.triangleFaces.end(), (size_t)count, faceIndex);
+
+        for (size_t t = first; t < mesh.indices.size(); t += 3) {
+            volume += signedVolume6(body, &mesh.indices[t]);
+        }
+    }
+
+    finishMesh(mesh, volume);
+}
+
+void tessellateBody(const Body* body, TriangleMesh& mesh, ThreadPool& pool) {
+    mesh.clear();
+    if (!body) return;
+
+    fillPositions(body, mesh);
+
+    // 各块独立三角化，再按块顺序拼接，结果与顺序版本逐字节相同
+    FaceChunks chunks(body, 64);
+    std::vector<ChunkMesh> parts(chunks.chunk_count());
+    parallelForChunks(pool, chunks.chunk_count(), [&](size_t chunk, unsigned) {
+        ChunkMesh& part = parts[chunk];
+        const std::vector<Face*>& faceList = chunks.faces();
+        size_t begin = chunks.chunk_begin(chunk), end = chunks.chunk_end(chunk);
+        part.faceNormals.resize(end - begin);
+        part.triangleCounts.resize(end - begin);
+        for (size_t i = begin; i < end; i++) {
+            size_t first = part.indices.size();
+            part.triangleCounts[i - begin] = tessellateFace(faceList[i], part.indices, &part.faceNormals[i - begin]);
+            for (size_t t = first; t < part.indices.size(); t += 3) {
+                part.volume += signedVolume6(body, &part.indices[t]);
+            }
+        }
+    });
+
+    size_t indexCount = 0;
+    double volume = 0;
+    for (const ChunkMesh& part : parts) {
+        indexCount += part.indices.size();
+        volume += part.volume;
+    }
+    mesh.indices.reserve(indexCount);
+    mesh.triangleFaces.reserve(indexCount / 3);
+    mesh.faceNormals.reserve(chunks.face_count());
+    for (size_t c = 0; c < parts.size(); c++) {
+        const ChunkMesh& part = parts[c];
+        mesh.indices.insert(mesh.indices.end(), part.indices.begin(), part.indices.end());
+        for (size_t f = 0; f < part.triangleCounts.size(); f++) {
+            uint32_t faceIndex = (uint32_t)mesh.faceNormals.size();
+            mesh.faceNormals.push_back(part.faceNormals[f]);
+            mesh.triangleFaces.insert(mesh.triangleFaces.end(), (size_t)part.triangleCounts[f], faceIndex);
+        }
+    }
+
+    finishMesh(mesh, volume);
+}
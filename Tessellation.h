@@ -0,0 +1,55 @@
+#ifndef _TESSELLATION_H_
+#define _TESSELLATION_H_
+
+#include <vector>
+#include <cstdint>
+#include "SolidModel.h"
+#include "Rendering.h"
+#include "ThreadPool.h"
+
+// 三角化结果 - 顶点按 Vertex::id_ 编号，与 Body::vertices_ 一一对应
+typedef struct TriangleMesh
+{
+    std::vector<Point3D> positions;       // 顶点位置
+    std::vector<Point3D> vertexNormals;   // 顶点法向（相邻面法向按面积加权平均），用于Gouraud着色
+    std::vector<Point3D> faceNormals;     // 面法向，用于平面着色
+    std::vector<uint32_t> indices;        // 三角形顶点下标，每三个一组
+    std::vector<uint32_t> triangleFaces;  // 每个三角形所属面的编号（faceNormals 的下标）
+
+    size_t triangleCount() const { return triangleFaces.size(); }
+
+    /** 各数组已分配的字节数 */
+    size_t memoryBytes() const
+    {
+        return (positions.capacity() + vertexNormals.capacity() + faceNormals.capacity()) * sizeof(Point3D) +
+               (indices.capacity() + triangleFaces.capacity()) * sizeof(uint32_t);
+    }
+
+    void clear()
+    {
+        positions.clear();
+        vertexNormals.clear();
+        faceNormals.clear();
+        indices.clear();
+        triangleFaces.clear();
+    }
+} TriangleMesh;
+
+// 用 Newell 方法计算环的法向，长度等于环所围面积的两倍
+Point3D loopNormal(const Loop* loop);
+
+// 面的单位法向（面积最大的环的 Newell 法向）
+Point3D faceNormal(const Face* face);
+
+// 将一个平面面（外环加任意个内环）三角化，结果以顶点 id 追加到 outIndices
+// 返回值: 生成的三角形个数
+int tessellateFace(const Face* face, std::vector<uint32_t>& outIndices, Point3D* outNormal);
+
+// 将整个实体三角化，并计算面法向和顶点法向
+// 若实体的环方向整体朝内（有向体积为负），三角形绕向会被翻转，保证法向朝外
+void tessellateBody(const Body* body, TriangleMesh& mesh);
+
+// 并行版本：面按块分配到线程池上三角化，结果与顺序版本相同
+void tessellateBody(const Body* body, TriangleMesh& mesh, ThreadPool& pool);
+
+#endif // !_TESSELLATION_H_
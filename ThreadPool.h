@@ -0,0 +1,41 @@
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定大小的线程池
+// 任务按提交顺序执行，wait() 阻塞直到所有已提交的任务完成
+// 任务不得抛出异常，需要时由任务自身捕获并记录
+class ThreadPool
+{
+public:
+    // _threads 为0时使用硬件线程数
+    explicit ThreadPool(unsigned _threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> _task);
+    void wait();
+
+    unsigned size() const { return (unsigned)workers_.size(); }
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_cv_;   // 有新任务或需要退出
+    std::condition_variable done_cv_;   // 所有任务完成
+    size_t pending_ = 0;                // 已提交但尚未完成的任务数
+    bool stop_ = false;
+};
+
+#endif // !_THREAD_POOL_H_
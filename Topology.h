@@ -0,0 +1,223 @@
+#ifndef _TOPOLOGY_H_
+#define _TOPOLOGY_H_
+
+#include <cstddef>
+#include <iterator>
+#include "SolidModel.h"
+
+// 拓扑遍历的范围迭代器与邻接查询
+// 迭代器只保存当前指针（环形遍历另存起点），展开后与手写的 do { ... } while (he != start) 循环相同，
+// 不分配内存，可直接用于范围 for：
+//     for (Face* f : faces(body))
+//         for (Loop* lp : loops(f))
+//             for (Halfedge* he : halfedges(lp)) ...
+
+namespace topology_detail {
+
+// 沿 next 指针前进、遇到 nullptr 结束的链表
+template <class T, T* T::*Next>
+class ListIterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T* value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* const* pointer;
+    typedef T* reference;
+
+    explicit ListIterator(T* _cur = nullptr) : cur_(_cur) {}
+
+    T* operator*() const { return cur_; }
+    ListIterator& operator++() { cur_ = cur_->*Next; return *this; }
+    ListIterator operator++(int) { ListIterator old = *this; ++*this; return old; }
+    bool operator==(const ListIterator& _o) const { return cur_ == _o.cur_; }
+    bool operator!=(const ListIterator& _o) const { return cur_ != _o.cur_; }
+
+private:
+    T* cur_;
+};
+
+// 环形遍历半边：Step 给出下一条半边，回到起点（或遇到断链）时结束；Proj 决定解引用得到什么
+template <class Step, class Proj>
+class CircularIterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef decltype(Proj::get((Halfedge*)nullptr)) value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef value_type reference;
+
+    CircularIterator() : cur_(nullptr), start_(nullptr) {}
+    explicit CircularIterator(Halfedge* _start) : cur_(_start), start_(_start) {}
+
+    value_type operator*() const { return Proj::get(cur_); }
+    Halfedge* halfedge() const { return cur_; }
+    CircularIterator& operator++()
+    {
+        cur_ = Step::next(cur_);
+        if (cur_ == start_) cur_ = nullptr;
+        return *this;
+    }
+    CircularIterator operator++(int) { CircularIterator old = *this; ++*this; return old; }
+    bool operator==(const CircularIterator& _o) const { return cur_ == _o.cur_; }
+    bool operator!=(const CircularIterator& _o) const { return cur_ != _o.cur_; }
+
+private:
+    Halfedge* cur_;
+    Halfedge* start_;
+};
+
+template <class It>
+class Range
+{
+public:
+    Range(It _begin, It _end) : begin_(_begin), end_(_end) {}
+    It begin() const { return begin_; }
+    It end() const { return end_; }
+    bool empty() const { return begin_ == end_; }
+
+private:
+    It begin_;
+    It end_;
+};
+
+// 环内的下一条半边
+struct LoopStep { static Halfedge* next(Halfedge* _he) { return _he->next_he_; } };
+// 绕顶点旋转到下一条出半边：对边以该顶点为终点，其后继以该顶点为起点
+struct VertexStep { static Halfedge* next(Halfedge* _he) { return _he->oppo_he_ ? _he->oppo_he_->next_he_ : nullptr; } };
+
+struct ProjHalfedge { static Halfedge* get(Halfedge* _he) { return _he; } };
+struct ProjStartVertex { static Vertex* get(Halfedge* _he) { return _he->start_vertex_; } };
+struct ProjToVertex { static Vertex* get(Halfedge* _he) { return _he->to_vertex_; } };
+struct ProjFace { static Face* get(Halfedge* _he) { return _he->loop_ ? _he->loop_->face_ : nullptr; } };
+
+} // namespace topology_detail
+
+typedef topology_detail::ListIterator<Face, &Face::next_face_> FaceIterator;
+typedef topology_detail::ListIterator<Loop, &Loop::next_loop_> LoopIterator;
+typedef topology_detail::CircularIterator<topology_detail::LoopStep, topology_detail::ProjHalfedge> LoopHalfedgeIterator;
+typedef topology_detail::CircularIterator<topology_detail::LoopStep, topology_detail::ProjStartVertex> LoopVertexIterator;
+typedef topology_detail::CircularIterator<topology_detail::VertexStep, topology_detail::ProjHalfedge> OutgoingHalfedgeIterator;
+typedef topology_detail::CircularIterator<topology_detail::VertexStep, topology_detail::ProjToVertex> NeighbourVertexIterator;
+typedef topology_detail::CircularIterator<topology_detail::VertexStep, topology_detail::ProjFace> IncidentFaceIterator;
+
+//--- 遍历范围 ---//
+
+/** 体的所有面 */
+inline topology_detail::Range<FaceIterator> faces(const Body* _body)
+{
+    return {FaceIterator(_body ? _body->first_face_ : nullptr), FaceIterator()};
+}
+
+/** 面的所有环（外环与内环） */
+inline topology_detail::Range<LoopIterator> loops(const Face* _face)
+{
+    return {LoopIterator(_face ? _face->first_loop_ : nullptr), LoopIterator()};
+}
+
+/** 环上的所有半边，从 start_he_ 开始 */
+inline topology_detail::Range<LoopHalfedgeIterator> halfedges(const Loop* _loop)
+{
+    return {LoopHalfedgeIterator(_loop ? _loop->start_he_ : nullptr), LoopHalfedgeIterator()};
+}
+
+/** 环上的所有顶点（各半边的起点） */
+inline topology_detail::Range<LoopVertexIterator> loopVertices(const Loop* _loop)
+{
+    return {LoopVertexIterator(_loop ? _loop->start_he_ : nullptr), LoopVertexIterator()};
+}
+
+/** 从顶点出发的所有半边 */
+inline topology_detail::Range<OutgoingHalfedgeIterator> outgoingHalfedges(const Vertex* _v)
+{
+    return {OutgoingHalfedgeIterator(_v ? _v->he_ : nullptr), OutgoingHalfedgeIterator()};
+}
+
+/** 与顶点相邻的所有顶点 */
+inline topology_detail::Range<NeighbourVertexIterator> neighbourVertices(const Vertex* _v)
+{
+    return {NeighbourVertexIterator(_v ? _v->he_ : nullptr), NeighbourVertexIterator()};
+}
+
+/** 顶点周围的面（按出半边所在环的面，同一面可能出现多次） */
+inline topology_detail::Range<IncidentFaceIterator> incidentFaces(const Vertex* _v)
+{
+    return {IncidentFaceIterator(_v ? _v->he_ : nullptr), IncidentFaceIterator()};
+}
+
+//--- 邻接查询 ---//
+
+/** 环中从 _from 指向 _to 的半边，不存在时返回 nullptr */
+inline Halfedge* findHalfedge(const Loop* _loop, const Vertex* _from, const Vertex* _to)
+{
+    for (Halfedge* he : halfedges(_loop))
+    {
+        if (he->start_vertex_ == _from && he->to_vertex_ == _to) return he;
+    }
+    return nullptr;
+}
+
+/** 环中第一条以 _v 为终点的半边，不存在时返回 nullptr */
+inline Halfedge* findHalfedgeTo(const Loop* _loop, const Vertex* _v)
+{
+    for (Halfedge* he : halfedges(_loop))
+    {
+        if (he->to_vertex_ == _v) return he;
+    }
+    return nullptr;
+}
+
+/** 环中连接 _v0 与 _v1 的半边（任一方向），不存在时返回 nullptr */
+inline Halfedge* findEdgeHalfedge(const Loop* _loop, const Vertex* _v0, const Vertex* _v1)
+{
+    for (Halfedge* he : halfedges(_loop))
+    {
+        if ((he->start_vertex_ == _v0 && he->to_vertex_ == _v1) ||
+            (he->start_vertex_ == _v1 && he->to_vertex_ == _v0)) return he;
+    }
+    return nullptr;
+}
+
+/** 顶点 _v0 到 _v1 的出半边，两顶点不相邻时返回 nullptr */
+inline Halfedge* halfedgeBetween(const Vertex* _v0, const Vertex* _v1)
+{
+    for (Halfedge* he : outgoingHalfedges(_v0))
+    {
+        if (he->to_vertex_ == _v1) return he;
+    }
+    return nullptr;
+}
+
+/** 边两侧的面；悬边两侧为同一个面 */
+inline Face* edgeFace(const Edge* _e, int _side)
+{
+    Halfedge* he = _side == 0 ? _e->he0_ : _e->he1_;
+    return he && he->loop_ ? he->loop_->face_ : nullptr;
+}
+
+/** 顶点的度（相邻边数） */
+inline int vertexDegree(const Vertex* _v)
+{
+    int degree = 0;
+    for (Halfedge* he : outgoingHalfedges(_v))
+    {
+        (void)he;
+        degree++;
+    }
+    return degree;
+}
+
+/** 环的半边数 */
+inline int loopLength(const Loop* _loop)
+{
+    int length = 0;
+    for (Halfedge* he : halfedges(_loop))
+    {
+        (void)he;
+        length++;
+    }
+    return length;
+}
+
+#endif // !_TOPOLOGY_H_
@@ -0,0 +1,199 @@
+#ifndef _VISUAL_BODY_H_
+#define _VISUAL_BODY_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EdgeStrips.h"
+#include "FeatureEdges.h"
+#include "Rendering.h"
+#include "SolidModel.h"
+
+// 只用于显示的紧凑实体：顶点位置按编译期选择的存储策略保存，边保存为顶点下标对
+// Body 中的 Point 为三个 double，放进 Vertex 后连同指针和下标每个顶点占 40 字节；显示只需要单精度甚至更低的精度，
+// 这里单精度每个顶点 12 字节，16 位量化每个顶点 6 字节。拓扑仍以 Body 为准，VisualBody 在体修改后需重新 build。
+//
+// 存储策略提供：
+//   Stored                         每个顶点保存的数据
+//   frame(min, max, origin, step)  由包围盒确定解码用的仿射变换：坐标 = origin + step * raw
+//   encode(p, origin, step)        把 Body 中的坐标编码为 Stored
+//   raw(s, out)                    取出未经仿射变换的三个分量
+// 解码的仿射变换在 project 中并入视图变换，渲染时不逐点还原坐标。
+// 同时缓存边两侧的面和面法向（FeatureEdges），供每帧只绘制轮廓边和特征边时使用；
+// 以及把全部边串成的折线（EdgeStrips），绘制全部边时每个顶点只提交一次。
+
+// 单精度存储，解码为恒等变换
+struct FloatPositions
+{
+    typedef Point3D Stored;
+
+    static void frame(const double*, const double*, double* _origin, double* _step)
+    {
+        for (int k = 0; k < 3; k++) { _origin[k] = 0; _step[k] = 1; }
+    }
+    static Stored encode(const Point& _p, const double*, const double*)
+    {
+        return Stored{(float)_p[0], (float)_p[1], (float)_p[2]};
+    }
+    static void raw(const Stored& _s, float* _out) { _out[0] = _s.x; _out[1] = _s.y; _out[2] = _s.z; }
+};
+
+// 每个分量量化为包围盒内的 16 位整数，误差不超过包围盒边长的 1/131070
+struct Quantized16Positions
+{
+    typedef struct { uint16_t q[3]; } Stored;
+
+    static void frame(const double* _min, const double* _max, double* _origin, double* _step)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            _origin[k] = _min[k];
+            _step[k] = (_max[k] - _min[k]) / 65535.0;
+        }
+    }
+    static Stored encode(const Point& _p, const double* _origin, const double* _step)
+    {
+        Stored s;
+        for (int k = 0; k < 3; k++)
+        {
+            double q = _step[k] > 0 ? std::floor((_p[k] - _origin[k]) / _step[k] + 0.5) : 0;
+            s.q[k] = (uint16_t)std::min(65535.0, std::max(0.0, q));
+        }
+        return s;
+    }
+    static void raw(const Stored& _s, float* _out)
+    {
+        for (int k = 0; k < 3; k++) _out[k] = _s.q[k];
+    }
+};
+
+template <class Policy>
+class VisualBody
+{
+public:
+    typedef typename Policy::Stored Stored;
+
+    // 从实体复制顶点位置（按 Vertex::id_ 排列）和所有边，并建立轮廓边/特征边的缓存和折线
+    void build(const Body* _body)
+    {
+        positions_.clear();
+        edges_.clear();
+        features_.build(_body, features_.feature_angle());
+        buildEdgeStrips(_body, strips_);
+        if (!_body) return;
+
+        double lo[3] = {0, 0, 0}, hi[3] = {0, 0, 0};
+        bool first = true;
+        for (const Vertex* v : _body->vertices_)
+        {
+            if (!v) continue;
+            for (int k = 0; k < 3; k++)
+            {
+                if (first || v->p_[k] < lo[k]) lo[k] = v->p_[k];
+                if (first || v->p_[k] > hi[k]) hi[k] = v->p_[k];
+            }
+            first = false;
+        }
+        Policy::frame(lo, hi, origin_, step_);
+
+        positions_.reserve(_body->vertices_.size());
+        for (const Vertex* v : _body->vertices_)
+        {
+            positions_.push_back(Policy::encode(v ? v->p_ : Point(lo), origin_, step_));
+        }
+        positions_.shrink_to_fit();
+
+        edges_.reserve(_body->edges_.size() * 2);
+        for (const Edge* e : _body->edges_)
+        {
+            if (!isDrawableEdge(e)) continue;
+            edges_.push_back((uint32_t)e->he0_->start_vertex_->id_);
+            edges_.push_back((uint32_t)e->he0_->to_vertex_->id_);
+        }
+        edges_.shrink_to_fit();
+    }
+
+    size_t vertex_count() const { return positions_.size(); }
+    size_t edge_count() const { return edges_.size() / 2; }
+
+    /** 第 _edge 条边的两个顶点下标 */
+    uint32_t edge_start(size_t _edge) const { return edges_[2 * _edge]; }
+    uint32_t edge_end(size_t _edge) const { return edges_[2 * _edge + 1]; }
+
+    /** 解码后的顶点位置，供非渲染用途（如求中心点）使用 */
+    Point3D position(size_t _i) const
+    {
+        float r[3];
+        Policy::raw(positions_[_i], r);
+        return Point3D{(float)(origin_[0] + step_[0] * r[0]),
+                       (float)(origin_[1] + step_[1] * r[1]),
+                       (float)(origin_[2] + step_[2] * r[2])};
+    }
+
+    /** 全部边串成的折线，顶点下标与 project 的输出一致 */
+    const EdgeStrips& strips() const { return strips_; }
+
+    /** 顶点位置、边下标、轮廓边缓存和折线占用的字节数 */
+    size_t memory_bytes() const
+    {
+        return positions_.capacity() * sizeof(Stored) + edges_.capacity() * sizeof(uint32_t) +
+               features_.memory_bytes() + strips_.memoryBytes();
+    }
+
+    /** 当前视图下的轮廓边和特征边（边下标），见 FeatureEdges::select */
+    void select_edges(const ViewParams& _view, std::vector<uint32_t>& _edges) { features_.select(_view, _edges); }
+
+    FeatureEdges& features() { return features_; }
+    const FeatureEdges& features() const { return features_; }
+
+    // 把所有顶点投影到屏幕，变换与 projectPoint 相同：中心偏移 -> 绕X轴 -> 绕Y轴 -> 缩放平移（Y轴翻转）
+    // 解码的仿射变换与视图变换先合成一个 2x3 矩阵，每个顶点只做一次矩阵乘法；每个顶点只投影一次，边按下标共享结果
+    void project(const ViewParams& _view, int _width, int _height,
+                 std::vector<float>& _screen_x, std::vector<float>& _screen_y) const
+    {
+        double cx = std::cos(_view.rotationX), sx = std::sin(_view.rotationX);
+        double cy = std::cos(_view.rotationY), sy = std::sin(_view.rotationY);
+        double s = _view.scale * 100.0;
+        double view[2][3] = {
+            { s * cy, s * sy * sx, s * sy * cx },
+            { 0, -s * cx, s * sx }
+        };
+        double offset[2] = { (double)(_width / 2 + _view.translateX), (double)(_height / 2 + _view.translateY) };
+        const double center[3] = { _view.center.x, _view.center.y, _view.center.z };
+
+        float m[2][3], b[2];
+        for (int r = 0; r < 2; r++)
+        {
+            double t = offset[r];
+            for (int k = 0; k < 3; k++)
+            {
+                m[r][k] = (float)(view[r][k] * step_[k]);
+                t += view[r][k] * (origin_[k] - center[k]);
+            }
+            b[r] = (float)t;
+        }
+
+        size_t n = positions_.size();
+        _screen_x.resize(n);
+        _screen_y.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            float p[3];
+            Policy::raw(positions_[i], p);
+            _screen_x[i] = m[0][0] * p[0] + m[0][1] * p[1] + m[0][2] * p[2] + b[0];
+            _screen_y[i] = m[1][0] * p[0] + m[1][1] * p[1] + m[1][2] * p[2] + b[1];
+        }
+    }
+
+private:
+    std::vector<Stored> positions_;
+    std::vector<uint32_t> edges_;   // 每两个一组：起点下标、终点下标
+    FeatureEdges features_;
+    EdgeStrips strips_;
+    double origin_[3] = {0, 0, 0};
+    double step_[3] = {1, 1, 1};
+};
+
+#endif // !_VISUAL_BODY_H_
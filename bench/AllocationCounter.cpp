@@ -0,0 +1,26 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// 统计堆分配次数：替换全局 operator new，基准在计时区间前后读取计数
+// 拓扑记录来自 BodyArena，不经过这里；计入的是边表、顶点表的扩容等。
+// 替换放在单独的文件中，避免编译器在调用处内联后把自定义的分配与释放误判为不匹配。
+static std::atomic<size_t> heapAllocations(0);
+
+void* operator new(size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+size_t heapAllocationCount() {
+    return heapAllocations.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,43 @@
+#include <cstdio>
+#include <cstring>
+
+// 各基准测试的入口，参数为去掉子命令名后的命令行
+int runParallelBuildBench(int argc, char** argv);
+int runEulerOpsBench(int argc, char** argv);
+int runSnapshotBench(int argc, char** argv);
+int runPrimitiveBench(int argc, char** argv);
+
+struct BenchEntry {
+    const char* name;
+    const char* description;
+    int (*run)(int, char**);
+};
+
+static const BenchEntry BENCHES[] = {
+    {"parallel-build", "并行构建大量独立零件，测量线程数扩展性", runParallelBuildBench},
+    {"euler-ops", "各欧拉操作随环长和体规模的耗时与分配次数（CSV）", runEulerOpsBench},
+    {"snapshot", "边编辑边发布只读快照，读者线程同时检查快照", runSnapshotBench},
+    {"primitives", "基本体按表一次建立与逐个执行欧拉操作的耗时对比", runPrimitiveBench},
+};
+
+static void printUsage(const char* exe) {
+    printf("用法: %s <基准名> [参数...]\n\n可用的基准:\n", exe);
+    for (const BenchEntry& bench : BENCHES) {
+        printf("  %-16s %s\n", bench.name, bench.description);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    for (const BenchEntry& bench : BENCHES) {
+        if (strcmp(argv[1], bench.name) == 0) {
+            return bench.run(argc - 2, argv + 2);
+        }
+    }
+    printf("未知的基准: %s\n\n", argv[1]);
+    printUsage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../EulerOperations.h"
+#include "../Topology.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 程序启动以来 operator new 的调用次数，见 AllocationCounter.cpp
+size_t heapAllocationCount();
+
+namespace {
+
+// 硬件缓存未命中计数，只在 Linux 上通过 perf_event_open 提供；不可用时返回 -1
+class CacheMissCounter
+{
+public:
+    CacheMissCounter()
+    {
+#if defined(__linux__)
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    ~CacheMissCounter()
+    {
+#if defined(__linux__)
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    void start()
+    {
+#if defined(__linux__)
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    long long stop()
+    {
+#if defined(__linux__)
+        if (fd_ < 0) return -1;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd_, &count, sizeof(count)) != (ssize_t)sizeof(count)) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// 被测的欧拉操作
+enum BenchOp { OP_MVFS, OP_MEV, OP_MEF, OP_KEMR, OP_KFMRH };
+const char* OP_NAMES[] = {"mvfs", "mev", "mef", "kemr", "kfmrh"};
+
+// 扫描方式：loop 在正 n 棱柱的顶面（环长 n）上操作；body 在同一棱柱的一个侧面（环长 4）上操作，
+// 环长不变而体的规模随 n 增长，两者对照即可区分环长和体规模各自的影响
+enum BenchSweep { SWEEP_LOOP, SWEEP_BODY };
+const char* SWEEP_NAMES[] = {"loop", "body"};
+
+// 一次测量所需的实体和操作数；准备工作不计时
+struct Fixture {
+    std::unique_ptr<EulerOperations> ops;
+    Loop* loop = nullptr;        // 被操作的环
+    Loop* bottom = nullptr;      // 底面的环，kfmrh 的外环
+    Vertex* v0 = nullptr;
+    Vertex* v1 = nullptr;
+    Loop* hole = nullptr;        // kfmrh 要并入底面的环
+    size_t loopLength = 0;       // 操作前被操作环的长度
+    size_t bodyEdges = 0;        // 操作前体的边数
+};
+
+// 与 ParallelBuildBench 相同的正 n 棱柱；返回顶面、底面和第一个侧面的环
+void buildPrism(EulerOperations& ops, int segments, Loop*& top, Loop*& bottom, Loop*& side) {
+    std::vector<Vertex*> lower(segments), upper(segments);
+    auto corner = [&](int i, double z) {
+        double a = 2.0 * 3.14159265358979323846 * i / segments;
+        return Point(std::cos(a), std::sin(a), z);
+    };
+
+    lower[0] = ops.mvfs(corner(0, 0));
+    top = ops.get_body()->first_face_->first_loop_;
+    for (int i = 1; i < segments; i++) {
+        lower[i] = ops.new_vertex(corner(i, 0));
+        ops.mev(lower[i - 1], lower[i], top);
+    }
+    bottom = ops.mef(lower[segments - 1], lower[0], top);
+    for (int i = 0; i < segments; i++) {
+        upper[i] = ops.new_vertex(corner(i, 1));
+        ops.mev(lower[i], upper[i], top);
+    }
+    side = nullptr;
+    for (int i = 0; i < segments; i++) {
+        Loop* quad = ops.mef(upper[i], upper[(i + 1) % segments], top);
+        if (!side) side = quad;
+    }
+}
+
+// 含 _v0、_v1 之间的边且边的两条半边都在其中的环
+Loop* bridgeLoop(std::initializer_list<Loop*> loops, Vertex* v0, Vertex* v1) {
+    for (Loop* loop : loops) {
+        Halfedge* he = findEdgeHalfedge(loop, v0, v1);
+        if (he && he->oppo_he_ && he->oppo_he_->loop_ == loop) return loop;
+    }
+    return nullptr;
+}
+
+// 按操作准备实体：被测操作在环中查找的位置取最坏情况，即环遍历顺序的最后一个顶点
+bool prepare(Fixture& f, BenchOp op, BenchSweep sweep, int segments) {
+    f.ops.reset(new EulerOperations());
+    f.ops->set_verbose(false);
+    if (op == OP_MVFS) return true;
+
+    Loop* top = nullptr;
+    Loop* side = nullptr;
+    buildPrism(*f.ops, segments, top, f.bottom, side);
+    f.loop = sweep == SWEEP_LOOP ? top : side;
+    if (!f.loop || !f.bottom) return false;
+
+    Halfedge* start = f.loop->start_he_;
+    Vertex* last = start->start_vertex_;   // 以它为终点的半边最后被遍历到
+    switch (op) {
+    case OP_MEV:
+        f.v0 = last;
+        f.v1 = f.ops->new_vertex(Point(0, 0, 0.5));
+        break;
+    case OP_MEF: {
+        // 把环大致对半分开
+        size_t half = (size_t)loopLength(f.loop) / 2;
+        Halfedge* he = start;
+        for (size_t i = 0; i < half; i++) he = he->next_he_;
+        f.v0 = last;
+        f.v1 = he->start_vertex_;
+        break;
+    }
+    case OP_KEMR:
+    case OP_KFMRH: {
+        // 从 last 引出一条桥边，末端再连成三角形：桥边两侧都在同一个环中，kemr 删去桥边后三角形成为内环
+        const Point& p = last->p_;
+        Vertex* w = f.ops->new_vertex(Point(p[0] * 0.5, p[1] * 0.5, 0.5));
+        Vertex* x = f.ops->new_vertex(Point(p[0] * 0.4, p[1] * 0.5, 0.5));
+        Vertex* y = f.ops->new_vertex(Point(p[0] * 0.5, p[1] * 0.4, 0.5));
+        if (!f.ops->mev(last, w, f.loop) || !f.ops->mev(w, x, f.loop) || !f.ops->mev(x, y, f.loop)) return false;
+        Loop* ring = f.ops->mef(y, w, f.loop);
+        if (!ring) return false;
+        Loop* bridged = bridgeLoop({f.loop, ring}, last, w);
+        if (!bridged) return false;
+        Loop* triangle = bridged == f.loop ? ring : f.loop;
+        f.loop = bridged;
+        f.v0 = last;
+        f.v1 = w;
+        if (op == OP_KFMRH) {
+            // 删去桥边后，把三角形面的环并入底面
+            if (!f.ops->kemr(last, w, bridged)) return false;
+            f.hole = triangle;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    f.loopLength = (size_t)loopLength(f.loop);
+    f.bodyEdges = f.ops->get_body()->edges_.size();
+    return true;
+}
+
+bool runOp(Fixture& f, BenchOp op) {
+    switch (op) {
+    case OP_MVFS: return f.ops->mvfs(Point(0, 0, 0)) != nullptr;
+    case OP_MEV: return f.ops->mev(f.v0, f.v1, f.loop) != nullptr;
+    case OP_MEF: return f.ops->mef(f.v0, f.v1, f.loop) != nullptr;
+    case OP_KEMR: return f.ops->kemr(f.v0, f.v1, f.loop) != nullptr;
+    case OP_KFMRH: {
+        Face* dead = f.hole->face_;
+        f.ops->kfmrh(f.bottom, f.hole);
+        return f.hole->face_ != dead;
+    }
+    }
+    return false;
+}
+
+struct Sample {
+    double ns = 0;
+    double heapAllocs = 0;
+    double arenaRecords = 0;
+    double arenaReserved = 0;
+    double cacheMisses = -1;
+    size_t loopLength = 0;
+    size_t bodyEdges = 0;
+};
+
+size_t arenaRecords(const Fixture& f) {
+    const Body* body = f.ops->get_body();
+    return body ? body->arena_.records_live() : 0;
+}
+size_t arenaReserved(const Fixture& f) {
+    const Body* body = f.ops->get_body();
+    return body ? body->arena_.bytes_reserved() : 0;
+}
+
+// 准备 batch 个实体，每个上执行一次操作，整批计时；返回每次操作的平均值
+bool measure(BenchOp op, BenchSweep sweep, int segments, size_t batch, CacheMissCounter& misses, Sample& sample) {
+    std::vector<Fixture> fixtures(batch);
+    for (Fixture& f : fixtures) {
+        if (!prepare(f, op, sweep, segments)) return false;
+    }
+    long long recordsBefore = 0, reservedBefore = 0;
+    for (const Fixture& f : fixtures) {
+        recordsBefore += (long long)arenaRecords(f);
+        reservedBefore += (long long)arenaReserved(f);
+    }
+
+    size_t failed = 0;
+    size_t allocsBefore = heapAllocationCount();
+    misses.start();
+    auto t0 = std::chrono::steady_clock::now();
+    for (Fixture& f : fixtures) failed += !runOp(f, op);
+    auto t1 = std::chrono::steady_clock::now();
+    long long missCount = misses.stop();
+    size_t allocs = heapAllocationCount() - allocsBefore;
+    if (failed) return false;
+
+    long long recordsAfter = 0, reservedAfter = 0;
+    for (const Fixture& f : fixtures) {
+        recordsAfter += (long long)arenaRecords(f);
+        reservedAfter += (long long)arenaReserved(f);
+    }
+    sample.ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / batch;
+    sample.heapAllocs = (double)allocs / batch;
+    sample.arenaRecords = (double)(recordsAfter - recordsBefore) / batch;
+    sample.arenaReserved = (double)(reservedAfter - reservedBefore) / batch;
+    sample.cacheMisses = missCount >= 0 ? (double)missCount / batch : -1;
+    sample.loopLength = fixtures[0].loopLength;
+    sample.bodyEdges = fixtures[0].bodyEdges;
+    return true;
+}
+
+void printRow(BenchOp op, const char* sweep, int segments, size_t batch, std::vector<Sample>& samples) {
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.ns < b.ns; });
+    const Sample& median = samples[samples.size() / 2];
+    printf("%s,%s,%d,%zu,%zu,%zu,%zu,%.1f,%.1f,%.3f,%.3f,%.1f,%.2f\n",
+           OP_NAMES[op], sweep, segments, median.loopLength, median.bodyEdges, batch, samples.size(),
+           median.ns, samples.front().ns, median.heapAllocs, median.arenaRecords, median.arenaReserved,
+           median.cacheMisses);
+}
+
+} // namespace
+
+// 参数: [最大棱柱边数=1024] [重复次数=5] [每批操作数上限=1024]
+// 输出为CSV（# 开头的行为注释），每行是一种操作在一个规模下重复测量的中位数，可直接用于不同版本间的对比
+int runEulerOpsBench(int argc, char** argv) {
+    int maxSegments = argc > 0 ? std::atoi(argv[0]) : 1024;
+    int reps = argc > 1 ? std::atoi(argv[1]) : 5;
+    size_t maxBatch = argc > 2 ? (size_t)std::atol(argv[2]) : 1024;
+    maxSegments = std::max(maxSegments, 4);
+    reps = std::max(reps, 1);
+    maxBatch = std::max<size_t>(maxBatch, 1);
+
+    CacheMissCounter misses;
+    printf("# euler-ops: 每种欧拉操作在不同环长（sweep=loop，正n棱柱的顶面）和体规模（sweep=body，同一棱柱的侧面）下的耗时\n");
+    printf("# segments 为棱柱边数；loop_length、body_edges 为操作前被操作环的半边数和体的边数\n");
+    printf("# heap_allocs_per_op 为 operator new 的调用次数；arena_records_per_op 为内存池存活记录数的净变化；"
+           "arena_reserved_per_op 为内存池新申请的字节数\n");
+    printf("# cache_misses_per_op 为 -1 表示硬件计数器不可用%s\n", misses.available() ? "" : "（本次运行不可用）");
+    printf("op,sweep,segments,loop_length,body_edges,batch,samples,ns_per_op,ns_per_op_min,"
+           "heap_allocs_per_op,arena_records_per_op,arena_reserved_per_op,cache_misses_per_op\n");
+
+    // mvfs 与环长、体规模无关，只测一行
+    {
+        std::vector<Sample> samples(reps);
+        for (Sample& s : samples) {
+            if (!measure(OP_MVFS, SWEEP_LOOP, 0, maxBatch, misses, s)) {
+                fprintf(stderr, "错误: mvfs 执行失败\n");
+                return 1;
+            }
+        }
+        printRow(OP_MVFS, "none", 0, maxBatch, samples);
+    }
+
+    // 棱柱边数取 4, 16, 64, ... 直到最大值；大规模时减少每批的实体数，使准备工作量大致不变
+    std::vector<int> sizes;
+    for (int n = 4; n < maxSegments; n *= 4) sizes.push_back(n);
+    sizes.push_back(maxSegments);
+
+    for (BenchOp op : {OP_MEV, OP_MEF, OP_KEMR, OP_KFMRH}) {
+        for (BenchSweep sweep : {SWEEP_LOOP, SWEEP_BODY}) {
+            for (int segments : sizes) {
+                size_t batch = std::min(maxBatch, std::max<size_t>(8, 65536 / (size_t)segments));
+                std::vector<Sample> samples(reps);
+                for (Sample& s : samples) {
+                    if (!measure(op, sweep, segments, batch, misses, s)) {
+                        fprintf(stderr, "错误: %s 在 %d 棱柱上执行失败\n", OP_NAMES[op], segments);
+                        return 1;
+                    }
+                }
+                printRow(op, SWEEP_NAMES[sweep], segments, batch, samples);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "../BodyBuilder.h"
+#include "../Primitives.h"
+
+// 用欧拉操作构建一个正 _segments 棱柱：与 createSimpleModel 构建立方体的步骤相同
+// 其他基准也用它构建规模可调的实体
+void buildPrism(EulerOperations& ops, int segments, double radius, double height, double offset) {
+    std::vector<Vertex*> bottom(segments), top(segments);
+    auto corner = [&](int i, double z) {
+        double a = 2.0 * 3.14159265358979323846 * i / segments;
+        return Point(offset + radius * std::cos(a), radius * std::sin(a), z);
+    };
+
+    bottom[0] = ops.mvfs(corner(0, 0));
+    Loop* loop = ops.get_body()->first_face_->first_loop_;
+    for (int i = 1; i < segments; i++) {
+        bottom[i] = ops.new_vertex(corner(i, 0));
+        ops.mev(bottom[i - 1], bottom[i], loop);
+    }
+    ops.mef(bottom[segments - 1], bottom[0], loop);
+    for (int i = 0; i < segments; i++) {
+        top[i] = ops.new_vertex(corner(i, height));
+        ops.mev(bottom[i], top[i], loop);
+    }
+    for (int i = 0; i < segments; i++) {
+        ops.mef(top[i], top[(i + 1) % segments], loop);
+    }
+}
+
+// 参数: [零件数=4000] [棱柱边数=32] [最大线程数=硬件线程数]
+int runParallelBuildBench(int argc, char** argv) {
+    size_t parts = argc > 0 ? (size_t)std::atol(argv[0]) : 4000;
+    int segments = argc > 1 ? std::atoi(argv[1]) : 32;
+    unsigned maxThreads = argc > 2 ? (unsigned)std::atoi(argv[2]) : std::thread::hardware_concurrency();
+    if (maxThreads == 0) maxThreads = 1;
+    segments = std::max(segments, 3);
+
+    BodyRecipe recipe = [segments](EulerOperations& ops, size_t i) {
+        buildPrism(ops, segments, 1.0 + (i % 7) * 0.1, 2.0, (double)i);
+    };
+
+    printf("parallel-build: %zu 个零件，每个为 %d 棱柱（%d 顶点 / %d 边 / %d 面）\n",
+           parts, segments, segments * 2, segments * 3, segments + 2);
+    printf("%8s %12s %14s %10s %10s\n", "threads", "time_ms", "parts_per_s", "speedup", "efficiency");
+
+    // 线程数取 1, 2, 4, ... 直到最大线程数
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    double baseline = 0;
+    for (unsigned threads : threadCounts) {
+        ThreadPool pool(threads);
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<Body*> bodies = buildBodiesParallel(pool, parts, recipe);
+        auto t1 = std::chrono::steady_clock::now();
+
+        size_t built = 0;
+        for (Body* body : bodies) {
+            if (body && body->face_num_ == segments + 2) built++;
+            delete body;
+        }
+        if (built != parts) {
+            printf("错误: 只有 %zu / %zu 个零件构建成功\n", built, parts);
+            return 1;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        if (threads == 1) baseline = ms;
+        double speedup = baseline / ms;
+        printf("%8u %12.2f %14.0f %10.2f %9.0f%%\n", threads, ms, parts / (ms / 1000.0), speedup, 100.0 * speedup / threads);
+    }
+    return 0;
+}
+
+namespace {
+
+struct PrimitiveTiming {
+    double eulerUs = -1;   // 没有对应的欧拉操作路径时为负
+    double tableUs = 0;
+    bool ok = true;
+};
+
+// 分别用 _euler 和 _table 构建 _parts 个实体，返回每个实体的平均耗时（微秒）；两种路径得到的点、边、面数必须一致
+// _euler 为空时只测按表实例化
+template <class Table>
+PrimitiveTiming timePrimitive(size_t _parts, const std::function<void(EulerOperations&, size_t)>& _euler, Table _table) {
+    PrimitiveTiming timing;
+    std::vector<Body*> bodies(_parts, nullptr);
+    auto average = [&](auto _build) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < _parts; i++) bodies[i] = _build(i);
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(t1 - t0).count() / (double)_parts;
+    };
+    auto counts = [](const Body* _body) {
+        return std::vector<size_t>{_body->vertices_.size(), _body->edges_.size(), (size_t)_body->face_num_};
+    };
+
+    std::vector<size_t> expected;
+    if (_euler) {
+        timing.eulerUs = average([&](size_t i) {
+            EulerOperations ops;
+            ops.set_verbose(false);
+            _euler(ops, i);
+            return ops.release_body();
+        });
+        expected = counts(bodies[0]);
+        for (Body*& body : bodies) {
+            timing.ok = timing.ok && body && counts(body) == expected;
+            delete body;
+            body = nullptr;
+        }
+    }
+    timing.tableUs = average(_table);
+    if (expected.empty()) expected = counts(bodies[0]);
+    for (Body* body : bodies) {
+        timing.ok = timing.ok && body && counts(body) == expected;
+        delete body;
+    }
+    return timing;
+}
+
+template <size_t N>
+PrimitiveTiming timeCylinder(size_t _parts) {
+    return timePrimitive(_parts,
+        [](EulerOperations& ops, size_t i) { buildPrism(ops, (int)N, 1.0, 2.0, (double)i); },
+        [](size_t) { return makeCylinder<N>(1.0, 0.0, 2.0); });
+}
+
+template <size_t M>
+PrimitiveTiming timeHoledBox(size_t _parts) {
+    return timePrimitive(_parts, nullptr,
+        [](size_t i) { return makeHoledBoxCylinder<M>(Point((double)i, 0, 0), Point(i + 4.0, 4, 2), 1.0); });
+}
+
+} // namespace
+
+// 基本体库按表一次建立与逐个执行欧拉操作的对比
+// 参数: [每种基本体的个数=2000]
+int runPrimitiveBench(int argc, char** argv) {
+    size_t parts = argc > 0 ? (size_t)std::atol(argv[0]) : 2000;
+    parts = std::max<size_t>(parts, 1);
+
+    struct Row {
+        const char* name;
+        PrimitiveTiming timing;
+    };
+    const Row rows[] = {
+        {"box", timePrimitive(parts,
+            [](EulerOperations& ops, size_t i) { buildPrism(ops, 4, 1.0, 2.0, (double)i); },
+            [](size_t i) { return makeBox(Point((double)i, 0, 0), Point(i + 1.0, 1, 2)); })},
+        {"prism-8", timeCylinder<8>(parts)},
+        {"prism-32", timeCylinder<32>(parts)},
+        {"prism-128", timeCylinder<128>(parts)},
+        {"prism-256", timeCylinder<256>(parts)},
+        {"holed-box-16", timeHoledBox<16>(parts)},
+        {"holed-box-64", timeHoledBox<64>(parts)},
+    };
+
+    printf("primitives: 每种基本体构建 %zu 个，欧拉操作路径与按表实例化的单个耗时\n", parts);
+    printf("%14s %12s %12s %10s\n", "primitive", "euler_us", "table_us", "speedup");
+    bool ok = true;
+    for (const Row& row : rows) {
+        if (row.timing.eulerUs < 0) {
+            printf("%14s %12s %12.2f %10s\n", row.name, "-", row.timing.tableUs, "-");
+        } else {
+            printf("%14s %12.2f %12.2f %9.1fx\n", row.name, row.timing.eulerUs, row.timing.tableUs, row.timing.eulerUs / row.timing.tableUs);
+        }
+        if (!row.timing.ok) {
+            printf("错误: %s 的点、边、面数不一致\n", row.name);
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../BodySnapshot.h"
+#include "../EulerOperations.h"
+#include "../Topology.h"
+
+// 见 ParallelBuildBench.cpp
+void buildPrism(EulerOperations& ops, int segments, double radius, double height, double offset);
+
+namespace {
+
+// 只读检查快照的拓扑：环上前驱、后继和所在的环互相一致，计数与实际相符，且满足欧拉-庞加莱公式（单个壳、无通孔）
+bool checkSnapshot(const Body* _body) {
+    size_t vertices = 0, loopCount = 0, faceCount = 0;
+    for (const Vertex* v : _body->vertices_) {
+        if (v) vertices++;
+    }
+    for (Face* f : faces(_body)) {
+        faceCount++;
+        for (Loop* lp : loops(f)) {
+            loopCount++;
+            if (lp->face_ != f) return false;
+            for (Halfedge* he : halfedges(lp)) {
+                if (he->loop_ != lp || he->next_he_->prev_he_ != he) return false;
+                if (he->to_vertex_ != he->next_he_->start_vertex_) return false;
+            }
+        }
+    }
+    if (faceCount != (size_t)_body->face_num_ || _body->edges_.size() != (size_t)_body->edge_num_) return false;
+    long long euler = (long long)vertices - (long long)_body->edges_.size() + (long long)faceCount - (long long)(loopCount - faceCount);
+    return euler == 2;
+}
+
+} // namespace
+
+// 写者不断修改实体并定期发布快照，读者线程同时取最新快照做只读检查
+// 参数: [棱柱边数=4096] [编辑次数=20000] [每次发布前的编辑数=64]
+int runSnapshotBench(int argc, char** argv) {
+    int segments = argc > 0 ? std::atoi(argv[0]) : 4096;
+    int edits = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int batch = argc > 2 ? std::atoi(argv[2]) : 64;
+    segments = std::max(segments, 3);
+    edits = std::max(edits, 0);
+    batch = std::max(batch, 1);
+
+    // 未修改时沿用上一个版本；换成另一个实体（即使地址和版本号相同）必须重新复制
+    {
+        SnapshotPublisher publisher;
+        EulerOperations first;
+        first.set_verbose(false);
+        buildPrism(first, segments, 1.0, 2.0, 0.0);
+        std::shared_ptr<const Body> s0 = publisher.publish(first.get_body());
+        if (publisher.publish(first.get_body()) != s0) {
+            printf("错误: 实体未修改时重新复制了快照\n");
+            return 1;
+        }
+        delete first.release_body();
+
+        EulerOperations second;
+        second.set_verbose(false);
+        buildPrism(second, segments, 1.0, 2.0, 0.0);
+        if (publisher.publish(second.get_body()) == s0) {
+            printf("错误: 新实体沿用了旧实体的快照\n");
+            return 1;
+        }
+    }
+
+    EulerOperations ops;
+    ops.set_verbose(false);
+    buildPrism(ops, segments, 1.0, 2.0, 0.0);
+    Body* body = ops.get_body();
+
+    // mev 不改变面，编辑时按顺序轮流在各个面的外环上长出一条悬边
+    std::vector<Loop*> targets;
+    for (Face* f : faces(body)) targets.push_back(f->first_loop_);
+
+    SnapshotPublisher publisher;
+    publisher.publish(body);
+
+    std::atomic<bool> done(false);
+    size_t checked = 0, distinct = 0, broken = 0;
+    std::thread reader([&] {
+        const Body* last = nullptr;
+        while (!done.load()) {
+            std::shared_ptr<const Body> snapshot = publisher.latest();
+            if (snapshot.get() != last) {
+                last = snapshot.get();
+                distinct++;
+            }
+            if (!checkSnapshot(snapshot.get())) broken++;
+            checked++;
+        }
+    });
+
+    printf("snapshot: %d 棱柱上做 %d 次 mev，每 %d 次发布一个快照\n", segments, edits, batch);
+
+    double cloneMs = 0;
+    int publishes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < edits; i++) {
+        Loop* lp = targets[i % targets.size()];
+        Vertex* v = lp->start_he_->start_vertex_;
+        Vertex* w = ops.new_vertex(Point(v->p_[0] * 0.99, v->p_[1] * 0.99, v->p_[2]));
+        if (!ops.mev(v, w, lp)) {
+            done = true;
+            reader.join();
+            printf("错误: 第 %d 次 mev 失败\n", i);
+            return 1;
+        }
+        if ((i + 1) % batch == 0 || i + 1 == edits) {
+            auto c0 = std::chrono::steady_clock::now();
+            publisher.publish(body);
+            cloneMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - c0).count();
+            publishes++;
+        }
+    }
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    done = true;
+    reader.join();
+
+    bool finalOk = checkSnapshot(publisher.latest().get()) && publisher.latest()->edges_.size() == body->edges_.size();
+    printf("%12s %12s %14s %14s %12s %12s\n", "publishes", "total_ms", "clone_ms_avg", "reader_checks", "distinct", "broken");
+    printf("%12d %12.2f %14.3f %14zu %12zu %12zu\n", publishes, totalMs, publishes ? cloneMs / publishes : 0.0, checked, distinct, broken);
+    printf("最终实体: %zu 顶点 / %zu 边 / %d 面\n", body->vertices_.size(), body->edges_.size(), body->face_num_);
+    if (broken != 0 || !finalOk) {
+        printf("错误: 读者看到了不完整的快照\n");
+        return 1;
+    }
+    return 0;
+}
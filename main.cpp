@@ -6,20 +6,22 @@
 #include <gdiplus.h>
 #include "EulerOperations.h"
 #include "SolidModel.h"
+#include "Rendering.h"
+#include "Tessellation.h"
+#include "Rasterizer.h"
+#include "Topology.h"
+#include "ModelPasses.h"
+#include "EulerScript.h"
+#include "ModelExport.h"
+#include "BooleanCut.h"
+#include "VisualBody.h"
+#include "MemoryReport.h"
+#include "BatchRender.h"
+#include "HudOverlay.h"
+#include "ModelLoader.h"
 
 using namespace std;
 
-// 渲染相关结构 - 3D点的表示
-typedef struct {
-    float x, y, z;
-} Point3D;
-
-// 渲染相关结构 - 3D线段的表示
-typedef struct {
-    Point3D start;  // 线段起点
-    Point3D end;    // 线段终点
-} LineSegment3D;
-
 // 渲染参数 - 用于控制3D模型的变换
 float rotationX = 0.0f;       // 绕X轴的旋转角度（弧度）
 float rotationY = 0.0f;       // 绕Y轴的旋转角度（弧度）
@@ -27,7 +29,50 @@ float scale = 1.0f;           // 缩放比例
 float translateX = 0.0f;      // X轴平移量（屏幕坐标）
 float translateY = 0.0f;      // Y轴平移量（屏幕坐标）
 Point3D centerPoint = {0.0f, 0.0f, 0.0f};  // 模型中心点
-vector<LineSegment3D> modelLines;  // 存储所有需要渲染的线段
+
+// 线框只用于显示：顶点位置按包围盒量化为16位，改为 VisualBody<FloatPositions> 则保存单精度坐标
+typedef VisualBody<Quantized16Positions> ModelVisual;
+ModelVisual modelVisual;          // 线框的顶点位置与边
+vector<float> screenX, screenY;   // 每帧投影后的顶点屏幕坐标
+bool featureEdgesOnly = false;    // 线框模式下只绘制轮廓边和特征边
+vector<uint32_t> visibleEdges;    // 每帧选出的轮廓边和特征边
+vector<Gdiplus::Point> stripPoints; // 绘制折线时一段连续折线的屏幕坐标
+
+// 渲染模式 - 线框或基于CPU光栅化的着色实体
+enum RenderMode {
+    RENDER_WIREFRAME,  // 线框
+    RENDER_FLAT,       // 平面着色
+    RENDER_GOURAUD     // Gouraud着色
+};
+RenderMode renderMode = RENDER_WIREFRAME;
+TriangleMesh modelMesh;          // 实体模型的三角化结果，着色模式使用
+SoftwareRasterizer* rasterizer = nullptr; // CPU三角形光栅化器，由WinMain创建（其工作线程随之创建和结束）
+Body* currentModel = nullptr;    // 当前显示的实体模型，导出时使用
+ThreadPool* workerPool = nullptr; // 后台计算用的线程池，由WinMain创建
+
+HudOverlay hud;                  // 操作提示和状态文字，只在内容或窗口大小改变时重新光栅化
+
+// 后台加载 - 窗口先打开，模型在后台线程上构建；完成前显示包围盒和已构建的边，界面线程从不等待
+const UINT WM_MODEL_PROGRESS = WM_APP + 1;  // 后台加载有新的预览或已结束
+ModelLoader* modelLoader = nullptr;  // 由WinMain创建
+LoadPreview loadPreview;             // 已取到的预览
+bool modelReady = false;             // 完整模型已换入：currentModel、modelMesh、modelVisual 有效
+bool modelFailed = false;            // 后台构建失败
+// 后台线程准备好、加载结束后由界面线程换入的显示数据
+TriangleMesh pendingMesh;
+ModelVisual pendingVisual;
+Point3D pendingCenter = {0.0f, 0.0f, 0.0f};
+
+// 局部重绘 - 记录上一次绘制完成时的状态和模型在屏幕上的范围
+// 相机或模式改变时只重绘上一帧与本帧模型范围的并集；状态未变时跳过渲染，只把双缓冲位图拷贝到窗口
+typedef struct {
+    ViewParams view;
+    RenderMode mode;
+    bool featureEdgesOnly;
+} FrameState;
+FrameState lastFrame = {};
+bool lastFrameValid = false;          // 双缓冲位图中是否为 lastFrame 的完整结果
+RECT lastFrameBounds = {0, 0, 0, 0};  // 上一帧模型的屏幕范围
 
 // 窗口和鼠标状态
 bool isDragging = false;      // 是否正在拖动鼠标
@@ -47,72 +92,32 @@ void cleanupGDIPlus() {
     Gdiplus::GdiplusShutdown(gdiplusToken);  // 关闭GDI+
 }
 
-// 辅助函数：将实体模型转换为线段集合
-// 此函数遍历实体模型的所有面、环和边，将每条边转换为渲染用的线段
-void modelToLineSegments(Body* body) {
+// 辅助函数：将实体模型转换为线框，并求出旋转中心
+// 线框只保存紧凑的顶点位置和每条边的两个顶点下标，绘制时每个顶点投影一次，各条边共享投影结果
+void modelToLineSegments(const Body* body, ModelVisual& visual, Point3D& center) {
     if (!body) return;  // 检查模型是否有效
     
-    modelLines.clear();  // 清空线段列表
-    vector<Edge*> processedEdges;  // 用于跟踪已处理的边，避免重复添加
+    visual.build(body);
     
-    // 计算模型中心点 - 用于旋转和平移操作
+    // 计算模型中心点 - 用于旋转和平移操作，每条边的两个端点各计一次
     double totalX = 0, totalY = 0, totalZ = 0;
     int vertexCount = 0;
-    
-    // 遍历所有面 - 实体模型由多个面组成
-    Face* currentFace = body->first_face_;
-    while (currentFace) {
-        // 遍历每个面的所有环（外边界和内边界）
-        Loop* currentLoop = currentFace->first_loop_;
-        while (currentLoop) {
-            // 获取环的起始半边
-            Halfedge* startHe = currentLoop->start_he_;
-            if (startHe) {
-                Halfedge* currentHe = startHe;
-                // 遍历环的所有半边
-                do {
-                    Edge* edge = currentHe->edge_;
-                    // 检查边是否有效且未处理过
-                    if (edge && find(processedEdges.begin(), processedEdges.end(), edge) == processedEdges.end()) {
-                        Vertex* v1 = currentHe->start_vertex_;  // 边的起始顶点
-                        Vertex* v2 = currentHe->to_vertex_;     // 边的终点顶点
-                        
-                        if (v1 && v2) {
-                            // 创建渲染用的线段
-                            LineSegment3D segment;
-                            segment.start.x = (float)v1->p_.x();  // 设置起点坐标
-                            segment.start.y = (float)v1->p_.y();
-                            segment.start.z = (float)v1->p_.z();
-                            segment.end.x = (float)v2->p_.x();    // 设置终点坐标
-                            segment.end.y = (float)v2->p_.y();
-                            segment.end.z = (float)v2->p_.z();
-                            modelLines.push_back(segment);  // 添加到线段列表
-                            
-                            // 累积顶点坐标用于计算中心点
-                            totalX += v1->p_.x() + v2->p_.x();
-                            totalY += v1->p_.y() + v2->p_.y();
-                            totalZ += v1->p_.z() + v2->p_.z();
-                            vertexCount += 2;
-                        }
-                        
-                        processedEdges.push_back(edge);  // 标记边为已处理
-                    }
-                    
-                    currentHe = currentHe->next_he_;  // 移动到下一个半边
-                } while (currentHe && currentHe != startHe);  // 循环直到回到起点
-            }
-            
-            currentLoop = currentLoop->next_loop_;  // 移动到下一个环
-        }
-        
-        currentFace = currentFace->next_face_;  // 移动到下一个面
+    for (Edge* edge : body->edges_) {
+        if (!edge || !edge->he0_) continue;
+        Vertex* v1 = edge->he0_->start_vertex_;  // 边的起始顶点
+        Vertex* v2 = edge->he0_->to_vertex_;     // 边的终点顶点
+        if (!v1 || !v2) continue;
+        totalX += v1->p_.x() + v2->p_.x();
+        totalY += v1->p_.y() + v2->p_.y();
+        totalZ += v1->p_.z() + v2->p_.z();
+        vertexCount += 2;
     }
     
     // 设置模型中心点 - 用于旋转变换的中心点
     if (vertexCount > 0) {
-        centerPoint.x = (float)(totalX / vertexCount);
-        centerPoint.y = (float)(totalY / vertexCount);
-        centerPoint.z = (float)(totalZ / vertexCount);
+        center.x = (float)(totalX / vertexCount);
+        center.y = (float)(totalY / vertexCount);
+        center.z = (float)(totalZ / vertexCount);
     }
 }
 
@@ -153,18 +158,14 @@ Gdiplus::Point projectPoint(Point3D p, int width, int height) {
     return Gdiplus::Point(px, py);
 }
 
-// 绘制线段函数 - 使用GDI+绘制一条3D线段在2D屏幕上
+// 绘制线段函数 - 使用GDI+绘制一条已投影到屏幕的线段
 // 参数:
 //   - graphics: GDI+绘图上下文
 //   - pen: 用于绘制的画笔
-//   - segment: 要绘制的3D线段
+//   - p1, p2: 线段两个端点的屏幕坐标
 //   - width: 窗口宽度
 //   - height: 窗口高度
-void drawLine(Gdiplus::Graphics* graphics, Gdiplus::Pen* pen, LineSegment3D segment, int width, int height) {
-    // 将线段的两个端点从3D投影到2D
-    Gdiplus::Point p1 = projectPoint(segment.start, width, height);
-    Gdiplus::Point p2 = projectPoint(segment.end, width, height);
-    
+void drawLine(Gdiplus::Graphics* graphics, Gdiplus::Pen* pen, Gdiplus::Point p1, Gdiplus::Point p2, int width, int height) {
     // 裁剪检查：确保线段的两个端点都在屏幕范围内
     // 这可以提高性能并避免绘制屏幕外的线段
     if (p1.X >= 0 && p1.X < width && p1.Y >= 0 && p1.Y < height &&
@@ -176,6 +177,103 @@ void drawLine(Gdiplus::Graphics* graphics, Gdiplus::Pen* pen, LineSegment3D segm
 
 
 
+// 绘制后台加载中的预览：包围盒的12条棱和已构建的边
+void drawLoadPreview(Gdiplus::Graphics* graphics, Gdiplus::Pen* boxPen, Gdiplus::Pen* edgePen, int width, int height) {
+    if (loadPreview.hasBounds) {
+        const Point3D& lo = loadPreview.min;
+        const Point3D& hi = loadPreview.max;
+        Gdiplus::Point corners[8];
+        for (int i = 0; i < 8; i++) {
+            Point3D p = {(i & 1) ? hi.x : lo.x, (i & 2) ? hi.y : lo.y, (i & 4) ? hi.z : lo.z};
+            corners[i] = projectPoint(p, width, height);
+        }
+        // 下标的三个二进制位分别对应 x、y、z 取最大值；只差一位的两个角之间有一条棱
+        for (int i = 0; i < 8; i++) {
+            for (int bit = 1; bit < 8; bit <<= 1) {
+                if (!(i & bit)) drawLine(graphics, boxPen, corners[i], corners[i | bit], width, height);
+            }
+        }
+    }
+    for (const LineSegment3D& segment : loadPreview.segments) {
+        drawLine(graphics, edgePen, projectPoint(segment.start, width, height), projectPoint(segment.end, width, height),
+                 width, height);
+    }
+}
+
+// 从欧拉操作脚本（文本或二进制）构建模型 - 新零件无需重新编译
+// 在后台线程上执行：读入后先由脚本中的顶点坐标提交包围盒，重放过程中每隔一批操作提交新建的边
+// 返回值: 指向创建的实体模型的指针，读取或校验失败、加载被取消时返回nullptr
+Body* loadScriptModel(const string& path, ModelLoader& loader) {
+    EulerScript script;
+    string error;
+    if (!readEulerScript(path, script, &error)) {
+        cerr << "无法读取脚本 " << path << ": " << error << endl;
+        return nullptr;
+    }
+    double lo[3], hi[3];
+    if (eulerScriptBounds(script, lo, hi)) {
+        loader.publish_bounds(Point3D{(float)lo[0], (float)lo[1], (float)lo[2]},
+                              Point3D{(float)hi[0], (float)hi[1], (float)hi[2]});
+    }
+    // 按操作顺序提交 mev / mef 新建的边，断点是已提交的操作数：kemr 会从 edges_ 中删除边，edges_ 的下标不能作为断点
+    size_t failed = 0, published = 0;
+    auto progress = [&loader, &script, &published](const Body* body, size_t done) {
+        vector<LineSegment3D> chunk;
+        for (; published < done; published++) {
+            const EulerOp& op = script.ops[published];
+            if (op.code != EULER_MEV && op.code != EULER_MEF) continue;
+            const Point& a = body->vertices_[op.a]->p_;
+            const Point& b = body->vertices_[op.b]->p_;
+            chunk.push_back(LineSegment3D{{(float)a[0], (float)a[1], (float)a[2]}, {(float)b[0], (float)b[1], (float)b[2]}});
+        }
+        loader.publish_segments(std::move(chunk));
+        return !loader.cancelled();
+    };
+    Body* body = replayEulerScript(script, &failed, progress, 4096);
+    if (!body) return nullptr;
+    cout << "脚本 " << path << ": " << script.ops.size() << " 个操作";
+    if (failed) cout << "，其中 " << failed << " 个执行失败";
+    cout << endl;
+    return body;
+}
+
+// 按空白拆分命令行，双引号内的空白不拆分
+vector<string> splitCommandLine(const string& line) {
+    vector<string> args;
+    string current;
+    bool quoted = false, pending = false;
+    for (char c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            pending = true;
+        } else if ((c == ' ' || c == '\t') && !quoted) {
+            if (pending) args.push_back(current);
+            current.clear();
+            pending = false;
+        } else {
+            current += c;
+            pending = true;
+        }
+    }
+    if (pending) args.push_back(current);
+    return args;
+}
+
+// 批量渲染模式：不创建窗口，按参数渲染各模型的多个角度并写出图像
+// 返回值: 进程退出码
+int runBatchMode(const vector<string>& args) {
+    BatchOptions options;
+    BatchReport report;
+    string error;
+    if (!parseBatchArguments(args, options, &error) || !runBatchRender(options, report, &error)) {
+        cerr << "批量渲染失败: " << error << endl;
+        cerr << "用法: hw3_render.exe --batch [--out 目录] [--angles K] [--size 宽x高] [--threads N] [--frames N] [--flat] [--wire] 模型..." << endl;
+        return 1;
+    }
+    printBatchReport(cout, report);
+    return report.errors.empty() ? 0 : 2;
+}
+
 // 创建立方体模型函数 - 使用欧拉操作创建基本实体模型
 // 返回值: 指向创建的实体模型的指针
 Body* createSimpleModel() {
@@ -184,7 +282,7 @@ Body* createSimpleModel() {
         
         // 第一步：使用mvfs（Make Vertex Face Solid）操作创建初始顶点和基本面
         // 这是欧拉操作的起点，创建一个顶点、一个面和一个实体
-        Point p0(0, 0, 0);  // 初始点坐标
+        Point p0(-1, -1, -1);  // 初始点坐标
         Vertex* v0 = eulerOps.mvfs(p0);  // 创建顶点并返回顶点指针
         
         if (!v0) {
@@ -202,26 +300,48 @@ Body* createSimpleModel() {
         // 获取初始面的环，用于后续添加边
         Loop* initialLoop = body->first_face_->first_loop_;
         
-        // 准备立方体的其他七个顶点坐标
-        Point p1(1, 0, 0);
-        Point p2(1, 1, 0);
-        Point p3(0, 1, 0);
-        Point p4(0, 0, 1);
-        Point p5(1, 0, 1);
-        Point p6(1, 1, 1);
-        Point p7(0, 1, 1);
+        // 立方体的八个顶点：底面 0-3，顶面 4-7，与线框中的外部立方体一致
+        Point corners[8] = {
+            Point(-1, -1, -1), Point(1, -1, -1), Point(1, 1, -1), Point(-1, 1, -1),
+            Point(-1, -1, 1),  Point(1, -1, 1),  Point(1, 1, 1),  Point(-1, 1, 1)
+        };
+        Vertex* v[8] = {v0};
         
-        // 尝试使用mev（Make Edge Vertex）操作创建其他顶点和边
-        // 注意：由于欧拉操作的限制，这里简化处理，实际渲染中会手动添加立方体框架
-        Halfedge* h1 = eulerOps.mev(v0, nullptr, initialLoop); // 尝试创建顶点v1
-        Halfedge* h2 = eulerOps.mev(v0, nullptr, initialLoop); // 尝试创建顶点v2
-        Halfedge* h3 = eulerOps.mev(v0, nullptr, initialLoop); // 尝试创建顶点v3
+        // 第二步：用mev依次生成底面的三条边和三个顶点
+        for (int i = 1; i < 4; i++) {
+            v[i] = eulerOps.new_vertex(corners[i]);
+            eulerOps.mev(v[i - 1], v[i], initialLoop);
+        }
         
-        // 注意：完整的立方体构建通常需要更多的欧拉操作（如mef、kemr等）
-        // 由于顶点构造的限制，我们在WinMain中手动添加立方体的线段
+        // 第三步：用mef闭合底面，得到底面和其余部分两个面
+        eulerOps.mef(v[3], v[0], initialLoop);
         
-        cout << "已创建立方体框架模型" << endl;
-        return body;
+        // 第四步：从底面四个顶点向上生成四条竖边
+        for (int i = 0; i < 4; i++) {
+            v[i + 4] = eulerOps.new_vertex(corners[i + 4]);
+            eulerOps.mev(v[i], v[i + 4], initialLoop);
+        }
+        
+        // 第五步：依次连接顶面相邻顶点，每次mef分出一个侧面，最后剩下的环即为顶面
+        for (int i = 0; i < 4; i++) {
+            if (!eulerOps.mef(v[4 + i], v[4 + (i + 1) % 4], initialLoop)) {
+                cout << "Error: mef 构建侧面失败" << endl;
+                return nullptr;
+            }
+        }
+        
+        // 第六步：沿z轴开一个截面为 1x1 的方形通孔，两端分别位于顶面和底面
+        ThroughHoleCutter cutter(eulerOps);
+        vector<Point> hole = {Point(-0.5, -0.5, 0), Point(0.5, -0.5, 0), Point(0.5, 0.5, 0), Point(-0.5, 0.5, 0)};
+        string error;
+        if (!cutter.cut(hole, Point(0, 0, 1), &error)) {
+            cout << "Error: 开通孔失败: " << error << endl;
+            return nullptr;
+        }
+        
+        cout << "已创建带通孔的立方体实体模型" << endl;
+        // 交出体的所有权，避免随eulerOps析构被释放
+        return eulerOps.release_body();
     } catch (const exception& e) {
         cout << "Exception in createSimpleModel: " << e.what() << endl;
         return nullptr;
@@ -230,6 +350,169 @@ Body* createSimpleModel() {
 
 
 
+// 后台线程的构建步骤：命令行给出脚本文件时从脚本重放，否则使用内置的欧拉操作
+Body* buildModel(ModelLoader& loader, const string& scriptPath) {
+    cout << "开始构建实体模型..." << endl;
+    if (!scriptPath.empty()) return loadScriptModel(scriptPath, loader);
+    Body* model = createSimpleModel();
+    loader.publish_bounds(model);
+    loader.publish_edges(model);
+    return model;
+}
+
+// 后台线程的准备步骤：按面并行校验拓扑并三角化，生成线框；结果放在 pending* 中，由界面线程换入
+void prepareModel(Body* model) {
+    cout << "\n模型信息:" << endl;
+    cout << "顶点数量: " << model->vertex_num_ << endl;
+    cout << "边数量: " << model->edge_num_ << endl;
+    cout << "面数量: " << model->face_num_ << endl;
+    
+    FaceChunks modelChunks(model);
+    ValidationReport report = validateBody(*workerPool, modelChunks);
+    cout << "拓扑校验: " << report.halfedgeCount << " 条半边, " << report.errorCount << " 个错误" << endl;
+    for (const string& message : report.messages) {
+        cerr << "  " << message << endl;
+    }
+    tessellateBody(model, pendingMesh, *workerPool);
+    cout << "三角形数量: " << pendingMesh.triangleCount() << endl;
+    
+    // 线框直接取自实体的边，通孔由布尔差开在实体上
+    modelToLineSegments(model, pendingVisual, pendingCenter);
+    cout << "线框数据: " << pendingVisual.vertex_count() << " 个顶点, " << pendingVisual.edge_count() << " 条边, "
+         << pendingVisual.memory_bytes() << " 字节" << endl;
+}
+
+// 把当前模型导出为 model.obj / model.stl / model.ply
+void exportCurrentModel() {
+    if (!currentModel || !workerPool) return;
+    for (const char* path : {"model.obj", "model.stl", "model.ply"}) {
+        ExportFormat format;
+        string error;
+        exportFormatFromPath(path, format);
+        if (exportBody(currentModel, modelMesh, path, format, *workerPool, &error)) {
+            cout << "已导出 " << path << endl;
+        } else {
+            cerr << "导出失败: " << error << endl;
+        }
+    }
+}
+
+// 在控制台输出当前模型及各渲染缓冲的内存占用
+// 参数 width、height 为窗口客户区大小，用于估算双缓冲位图（每像素4字节）；窗口尚未创建时传0
+void printCurrentMemory(int width, int height) {
+    if (!currentModel) return;
+    vector<BufferUsage> buffers = {
+        {"wireframe", modelVisual.memory_bytes()},
+        {"screen coords", (screenX.capacity() + screenY.capacity()) * sizeof(float)},
+        {"triangle mesh", modelMesh.memoryBytes()},
+        {"rasterizer", rasterizer ? rasterizer->memory_bytes() : 0}
+    };
+    if (width > 0 && height > 0) buffers.push_back({"back buffer", (size_t)width * height * 4});
+    printMemoryReport(cout, measureBody(currentModel), buffers);
+}
+
+// 界面线程：取走后台加载的新预览；加载结束时换入完整模型。返回是否有变化
+bool pollModelLoader() {
+    if (!modelLoader || modelReady || modelFailed) return false;
+    bool changed = modelLoader->take_preview(loadPreview);
+    if (changed && loadPreview.hasBounds) {
+        // 完整模型就绪前绕包围盒中心旋转
+        centerPoint = Point3D{(loadPreview.min.x + loadPreview.max.x) / 2, (loadPreview.min.y + loadPreview.max.y) / 2,
+                              (loadPreview.min.z + loadPreview.max.z) / 2};
+    }
+    if (!modelLoader->finished()) return changed;
+    
+    currentModel = modelLoader->take_body();
+    if (!currentModel) {
+        cerr << "无法创建模型" << endl;
+        modelFailed = true;
+        return true;
+    }
+    modelMesh = std::move(pendingMesh);
+    modelVisual = std::move(pendingVisual);
+    centerPoint = pendingCenter;
+    loadPreview = LoadPreview();
+    modelReady = true;
+    printCurrentMemory(0, 0);
+    return true;
+}
+
+// 当前交互状态对应的视图参数
+ViewParams currentView() {
+    return ViewParams{centerPoint, rotationX, rotationY, scale, translateX, translateY};
+}
+
+// 当前状态与上一次绘制完成时相同
+bool sameAsLastFrame(const ViewParams& view) {
+    const ViewParams& last = lastFrame.view;
+    return lastFrameValid && renderMode == lastFrame.mode && featureEdgesOnly == lastFrame.featureEdgesOnly &&
+           view.center.x == last.center.x && view.center.y == last.center.y && view.center.z == last.center.z &&
+           view.rotationX == last.rotationX && view.rotationY == last.rotationY && view.scale == last.scale &&
+           view.translateX == last.translateX && view.translateY == last.translateY;
+}
+
+// 把所有顶点投影到 screenX / screenY，返回模型在窗口内的屏幕范围
+// 线框与三角网格的顶点相同，两种模式共用；范围向外留出画笔线帽的宽度
+RECT modelBounds(const ViewParams& view, int width, int height) {
+    RECT bounds = {0, 0, 0, 0};
+    modelVisual.project(view, width, height, screenX, screenY);
+    if (screenX.empty()) return bounds;
+    float minX = screenX[0], maxX = screenX[0], minY = screenY[0], maxY = screenY[0];
+    for (size_t i = 1; i < screenX.size(); i++) {
+        minX = min(minX, screenX[i]);
+        maxX = max(maxX, screenX[i]);
+        minY = min(minY, screenY[i]);
+        maxY = max(maxY, screenY[i]);
+    }
+    const float MARGIN = 2.0f;
+    bounds.left = (LONG)max(0.0f, floor(minX - MARGIN));
+    bounds.top = (LONG)max(0.0f, floor(minY - MARGIN));
+    bounds.right = (LONG)min((float)width, ceil(maxX + MARGIN) + 1);
+    bounds.bottom = (LONG)min((float)height, ceil(maxY + MARGIN) + 1);
+    if (bounds.left >= bounds.right || bounds.top >= bounds.bottom) bounds = RECT{0, 0, 0, 0};
+    return bounds;
+}
+
+// 相机改变后请求重绘：只使上一帧与本帧模型范围的并集失效；相机未变时不重绘
+void requestRedraw(HWND hwnd, int width, int height) {
+    ViewParams view = currentView();
+    if (sameAsLastFrame(view)) return;
+    if (!lastFrameValid || !modelReady) {  // 加载中的预览不计算屏幕范围，整体重绘
+        InvalidateRect(hwnd, NULL, FALSE);
+        return;
+    }
+    RECT bounds = modelBounds(view, width, height);
+    RECT dirty;
+    UnionRect(&dirty, &lastFrameBounds, &bounds);
+    if (!IsRectEmpty(&dirty)) InvalidateRect(hwnd, &dirty, FALSE);
+}
+
+// 提示文字层的内容：操作说明和当前渲染模式
+vector<wstring> hudLines() {
+    vector<wstring> lines = {
+        L"左键拖动: 旋转",
+        L"右键拖动: 平移",
+        L"滚轮: 缩放",
+        L"S: 切换线框/平面着色/Gouraud着色",
+        L"E: 导出 model.obj / .stl / .ply",
+        L"M: 输出内存占用",
+        L"F: 线框只画轮廓边和特征边",
+        L"ESC: 退出"
+    };
+    if (renderMode == RENDER_WIREFRAME) {
+        lines.push_back(featureEdgesOnly ? L"当前: 线框（轮廓边和特征边）" : L"当前: 线框（全部边）");
+    } else {
+        lines.push_back(renderMode == RENDER_FLAT ? L"当前: 平面着色" : L"当前: Gouraud着色");
+    }
+    // 后台加载的状态，完整模型就绪后不再显示
+    if (modelFailed) {
+        lines.push_back(L"模型加载失败");
+    } else if (!modelReady) {
+        lines.push_back(L"加载中: 已构建 " + to_wstring(loadPreview.segments.size()) + L" 条边");
+    }
+    return lines;
+}
+
 // 窗口过程函数 - 处理所有Windows消息
 // 参数:
 //   - hwnd: 窗口句柄
@@ -243,11 +526,22 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     static HBITMAP hbmMem;    // 内存位图（用于双缓冲）
     static HBITMAP hbmOld;    // 保存旧的位图，用于清理
     static int width, height; // 窗口宽度和高度
+    // 每帧复用的GDI+对象，在WM_CREATE中创建，WM_DESTROY中释放
+    static Gdiplus::SolidBrush* backBrush;  // 线框模式的黑色背景
+    static Gdiplus::Pen* wirePen;           // 线框的红色画笔
+    static Gdiplus::Pen* proxyPen;          // 加载中包围盒的灰色画笔
     
     switch (uMsg) {
         case WM_CREATE: {  // 窗口创建时触发
             // 初始化GDI+库
             initGDIPlus();
+            backBrush = new Gdiplus::SolidBrush(Gdiplus::Color(0, 0, 0));
+            wirePen = new Gdiplus::Pen(Gdiplus::Color(255, 0, 0), 1.0f);  // 红色，线宽1像素
+            wirePen->SetLineJoin(Gdiplus::LineJoinRound);     // 设置线连接方式为圆形
+            wirePen->SetStartCap(Gdiplus::LineCapRound);      // 设置线帽为圆形
+            wirePen->SetEndCap(Gdiplus::LineCapRound);        // 设置线帽为圆形
+            proxyPen = new Gdiplus::Pen(Gdiplus::Color(96, 96, 96), 1.0f);
+            hud.set_lines(hudLines());
             
             // 获取窗口客户区大小
             RECT rect;
@@ -280,6 +574,8 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             ReleaseDC(hwnd, hdc);
             
             hbmOld = (HBITMAP)SelectObject(hdcMem, hbmMem);  // 选择新位图到内存DC
+            hud.invalidate_device();  // 文字层按新位图的设备格式重新生成
+            lastFrameValid = false;   // 新位图内容未定义，下一帧整体重绘
             InvalidateRect(hwnd, NULL, FALSE);  // 触发重绘
             
             return 0;
@@ -289,43 +585,114 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);  // 获取窗口DC
             
-            // 创建GDI+图形对象，用于高级绘图
-            Gdiplus::Graphics graphics(hdcMem);
-            
-            // 填充黑色背景
-            Gdiplus::SolidBrush backBrush(Gdiplus::Color(0, 0, 0));  // 黑色画笔
-            graphics.FillRectangle(&backBrush, 0, 0, width, height);
-            
-            // 创建红色画笔，用于绘制3D模型
-            Gdiplus::Pen pen(Gdiplus::Color(255, 0, 0), 1.0f);  // 红色，线宽1像素
-            pen.SetLineJoin(Gdiplus::LineJoinRound);     // 设置线连接方式为圆形
-            pen.SetStartCap(Gdiplus::LineCapRound);      // 设置线帽为圆形
-            pen.SetEndCap(Gdiplus::LineCapRound);        // 设置线帽为圆形
-            
-            // 绘制模型的所有线段
-            for (const auto& line : modelLines) {
-                drawLine(&graphics, &pen, line, width, height);
+            // 需要更新的区域：相机改变时为上一帧与本帧模型范围的并集，窗口被遮挡后露出时为露出的部分
+            RECT dirty = ps.rcPaint;
+            ViewParams view = currentView();
+            bool redraw = !sameAsLastFrame(view);
+            if (!lastFrameValid) {
+                SetRect(&dirty, 0, 0, width, height);
+            } else if (redraw) {
+                // 与文字层相交时把整个文字层并入更新区域，文字层每次都合成到重新绘制的背景上
+                RECT hudRect, overlap;
+                SetRect(&hudRect, 10, 10, 10 + hud.width(), 10 + hud.height());
+                if (IntersectRect(&overlap, &dirty, &hudRect)) UnionRect(&dirty, &dirty, &hudRect);
             }
+            int dirtyWidth = dirty.right - dirty.left, dirtyHeight = dirty.bottom - dirty.top;
             
-            // 添加操作提示文本
-            Gdiplus::Font font(L"Arial", 12);  // 创建字体
-            Gdiplus::SolidBrush textBrush(Gdiplus::Color(255, 255, 255));  // 白色文字
-            Gdiplus::StringFormat format;
-            format.SetAlignment(Gdiplus::StringAlignmentNear);  // 左对齐
-            
-            // 绘制操作说明
-            graphics.DrawString(L"左键拖动: 旋转", -1, &font, Gdiplus::PointF(10, 10), &format, &textBrush);
-            graphics.DrawString(L"右键拖动: 平移", -1, &font, Gdiplus::PointF(10, 30), &format, &textBrush);
-            graphics.DrawString(L"滚轮: 缩放", -1, &font, Gdiplus::PointF(10, 50), &format, &textBrush);
-            graphics.DrawString(L"ESC: 退出", -1, &font, Gdiplus::PointF(10, 70), &format, &textBrush);
+            if (redraw && dirtyWidth > 0 && dirtyHeight > 0) {
+                // 创建GDI+图形对象，只在更新区域内绘制
+                Gdiplus::Graphics graphics(hdcMem);
+                graphics.SetClip(Gdiplus::Rect(dirty.left, dirty.top, dirtyWidth, dirtyHeight));
+                
+                // 所有顶点一次投影到屏幕，同时得到本帧模型的屏幕范围
+                RECT bounds = modelBounds(view, width, height);
+                if (!modelReady) {
+                    // 加载中：不论渲染模式，画包围盒和已构建的边
+                    graphics.FillRectangle(backBrush, dirty.left, dirty.top, dirtyWidth, dirtyHeight);
+                    drawLoadPreview(&graphics, proxyPen, wirePen, width, height);
+                } else if (renderMode == RENDER_WIREFRAME) {
+                    // 填充黑色背景
+                    graphics.FillRectangle(backBrush, dirty.left, dirty.top, dirtyWidth, dirtyHeight);
+                    
+                    // 两个端点位于更新区域同一侧之外的边不可能与区域相交
+                    const float x0 = dirty.left - 2.0f, x1 = dirty.right + 2.0f;
+                    const float y0 = dirty.top - 2.0f, y1 = dirty.bottom + 2.0f;
+                    auto outside = [&](uint32_t a, uint32_t b) {
+                        float ax = screenX[a], ay = screenY[a], bx = screenX[b], by = screenY[b];
+                        return (ax < x0 && bx < x0) || (ax > x1 && bx > x1) || (ay < y0 && by < y0) || (ay > y1 && by > y1);
+                    };
+                    if (featureEdgesOnly) {
+                        // 只画当前视图下的轮廓边和朝向观察者的特征边，按边的顶点下标逐条绘制
+                        modelVisual.select_edges(view, visibleEdges);
+                        for (uint32_t i : visibleEdges) {
+                            uint32_t a = modelVisual.edge_start(i), b = modelVisual.edge_end(i);
+                            if (outside(a, b)) continue;
+                            drawLine(&graphics, wirePen, Gdiplus::Point((int)screenX[a], (int)screenY[a]),
+                                     Gdiplus::Point((int)screenX[b], (int)screenY[b]), width, height);
+                        }
+                    } else {
+                        // 全部边按预先串好的折线绘制，每段连续折线一次 DrawLines，共享的顶点只提交一次；
+                        // 与更新区域不相交的边把折线断开
+                        auto flush = [&]() {
+                            if (stripPoints.size() >= 2) graphics.DrawLines(wirePen, stripPoints.data(), (INT)stripPoints.size());
+                            stripPoints.clear();
+                        };
+                        const EdgeStrips& strips = modelVisual.strips();
+                        for (size_t s = 0; s < strips.stripCount(); s++) {
+                            for (uint32_t k = strips.offsets[s] + 1; k < strips.offsets[s + 1]; k++) {
+                                uint32_t a = strips.vertices[k - 1], b = strips.vertices[k];
+                                if (outside(a, b)) {
+                                    flush();
+                                    continue;
+                                }
+                                if (stripPoints.empty()) stripPoints.push_back(Gdiplus::Point((int)screenX[a], (int)screenY[a]));
+                                stripPoints.push_back(Gdiplus::Point((int)screenX[b], (int)screenY[b]));
+                            }
+                            flush();
+                        }
+                    }
+                } else {
+                    // 着色模式：CPU只光栅化与更新区域相交的分块（含背景），再把更新区域拷贝到内存DC
+                    rasterizer->resize(width, height);
+                    rasterizer->set_scissor(dirty.left, dirty.top, dirty.right, dirty.bottom);
+                    rasterizer->render(modelMesh, view, renderMode == RENDER_FLAT ? SHADE_FLAT : SHADE_GOURAUD);
+                    
+                    // 位图只描述更新区域所在的行，避免自上而下位图的起始行换算
+                    BITMAPINFO bmi = {};
+                    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+                    bmi.bmiHeader.biWidth = rasterizer->stride();
+                    bmi.bmiHeader.biHeight = -dirtyHeight;  // 负值表示自上而下的行顺序
+                    bmi.bmiHeader.biPlanes = 1;
+                    bmi.bmiHeader.biBitCount = 32;
+                    bmi.bmiHeader.biCompression = BI_RGB;
+                    SetDIBitsToDevice(hdcMem, dirty.left, dirty.top, dirtyWidth, dirtyHeight, dirty.left, 0, 0, dirtyHeight,
+                                      rasterizer->pixels() + (size_t)dirty.top * rasterizer->stride(), &bmi, DIB_RGB_COLORS);
+                }
+                
+                // 合成操作提示文字层，只在内容或窗口大小改变后重新光栅化
+                hud.draw(graphics, 10, 10);
+                
+                lastFrame = FrameState{view, renderMode, featureEdgesOnly};
+                lastFrameBounds = bounds;
+                lastFrameValid = true;
+            }
             
-            // 将内存DC中的内容复制到窗口DC，完成双缓冲绘制
-            BitBlt(hdc, 0, 0, width, height, hdcMem, 0, 0, SRCCOPY);
+            // 只把更新区域从内存DC复制到窗口DC；状态未变时（如窗口露出）不重新渲染
+            BitBlt(hdc, dirty.left, dirty.top, dirtyWidth, dirtyHeight, hdcMem, dirty.left, dirty.top, SRCCOPY);
             
             EndPaint(hwnd, &ps);  // 结束绘制
             return 0;
         }
         
+        case WM_MODEL_PROGRESS: {  // 后台加载有新的预览或已结束
+            if (pollModelLoader()) {
+                hud.set_lines(hudLines());
+                lastFrameValid = false;  // 预览和完整模型都没有上一帧的屏幕范围，整体重绘
+                InvalidateRect(hwnd, NULL, FALSE);
+            }
+            return 0;
+        }
+        
         case WM_LBUTTONDOWN: {  // 左键按下事件
             isDragging = true;  // 设置拖动状态为真
             lastMouseX = LOWORD(lParam);  // 记录当前鼠标X坐标
@@ -374,8 +741,8 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 // 更新上一次鼠标位置
                 lastMouseX = mouseX;
                 lastMouseY = mouseY;
-                // 触发窗口重绘，显示更新后的模型
-                InvalidateRect(hwnd, NULL, FALSE);
+                // 只重绘模型移动前后覆盖的区域，相机未变时不重绘
+                requestRedraw(hwnd, width, height);
             }
             return 0;
         }
@@ -388,14 +755,26 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             // 设置缩放比例的上下限，避免过度缩放
             if (scale < 0.1f) scale = 0.1f;  // 最小缩放比例
             if (scale > 5.0f) scale = 5.0f;  // 最大缩放比例
-            // 触发重绘
-            InvalidateRect(hwnd, NULL, FALSE);
+            // 触发重绘；缩放已到上下限时相机未变，不重绘
+            requestRedraw(hwnd, width, height);
             return 0;
         }
         
         case WM_KEYDOWN: {  // 键盘按键按下事件
             if (wParam == VK_ESCAPE) {  // ESC键 - 退出程序
                 PostMessage(hwnd, WM_CLOSE, 0, 0);  // 发送关闭消息
+            } else if (wParam == 'S') {  // S键 - 循环切换渲染模式
+                renderMode = (RenderMode)((renderMode + 1) % 3);
+                hud.set_lines(hudLines());
+                InvalidateRect(hwnd, NULL, FALSE);
+            } else if (wParam == 'E') {  // E键 - 导出模型
+                exportCurrentModel();
+            } else if (wParam == 'M') {  // M键 - 输出内存占用
+                printCurrentMemory(width, height);
+            } else if (wParam == 'F') {  // F键 - 切换全部边/只画轮廓边和特征边
+                featureEdgesOnly = !featureEdgesOnly;
+                hud.set_lines(hudLines());
+                InvalidateRect(hwnd, NULL, FALSE);
             }
             return 0;
         }
@@ -405,6 +784,13 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             SelectObject(hdcMem, hbmOld);  // 恢复旧的位图
             DeleteObject(hbmMem);          // 删除内存位图
             DeleteDC(hdcMem);              // 删除内存设备上下文
+            hud.release();                 // GDI+对象须在关闭GDI+之前释放
+            delete proxyPen;
+            delete wirePen;
+            delete backBrush;
+            proxyPen = nullptr;
+            wirePen = nullptr;
+            backBrush = nullptr;
             cleanupGDIPlus();              // 清理GDI+
             PostQuitMessage(0);            // 发送退出消息，结束消息循环
             return 0;
@@ -457,89 +843,47 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     // 设置控制台输出为UTF-8编码，确保中文正常显示
     SetConsoleOutputCP(CP_UTF8);
     
-    cout << "开始构建实体模型..." << endl;
-    
-    // 创建实体模型 - 使用欧拉操作
-    Body* model = createSimpleModel();
-    
-    // 检查模型是否创建成功
-    if (!model) {
-        cerr << "无法创建模型，程序退出" << endl;
-        return 1;
-    }
-    
-    // 输出模型信息到控制台
-    cout << "\n模型信息:" << endl;
-    cout << "顶点数量: " << model->vertex_num_ << endl;
-    cout << "边数量: " << model->edge_num_ << endl;
-    cout << "面数量: " << model->face_num_ << endl;
-    
-    // 注意：由于欧拉操作创建的模型可能不够完善，这里手动创建一个立方体框架并添加内部通孔
-    // 清空线段列表
-    modelLines.clear();
-    
-    // 定义外部立方体的8个顶点坐标
-    vector<Point3D> outerCubeVertices = {
-        {-1, -1, -1}, {1, -1, -1}, {1, 1, -1}, {-1, 1, -1},  // 底部四个点
-        {-1, -1, 1},  {1, -1, 1},  {1, 1, 1},  {-1, 1, 1}   // 顶部四个点
-    };
-    
-    // 定义外部立方体的12条边（用顶点索引对表示）
-    int outerCubeEdges[12][2] = {
-        {0, 1}, {1, 2}, {2, 3}, {3, 0},  // 底部四条边
-        {4, 5}, {5, 6}, {6, 7}, {7, 4},  // 顶部四条边
-        {0, 4}, {1, 5}, {2, 6}, {3, 7}   // 四条竖边
-    };
-    
-    // 为外部立方体的每条边创建线段对象并添加到渲染列表
-    for (int i = 0; i < 12; i++) {
-        LineSegment3D seg;
-        seg.start = outerCubeVertices[outerCubeEdges[i][0]];  // 设置边的起点
-        seg.end = outerCubeVertices[outerCubeEdges[i][1]];    // 设置边的终点
-        modelLines.push_back(seg);  // 添加到线段列表
+    // 以 --batch 开头时进入批量渲染模式，不创建窗口
+    vector<string> args = splitCommandLine(lpCmdLine ? lpCmdLine : "");
+    if (!args.empty() && args[0] == "--batch") {
+        return runBatchMode(vector<string>(args.begin() + 1, args.end()));
     }
     
-    // 定义内部长方体（通孔）的8个顶点坐标
-    // 内部长方体尺寸为外部立方体的一半，居中放置
-    // z坐标与外部立方体相同，使两端相切
-    float innerSize = 0.5f;  // 内部长方体相对于外部立方体的尺寸比例
-    vector<Point3D> innerCubeVertices = {
-        {-innerSize, -innerSize, -1.0f}, {innerSize, -innerSize, -1.0f},  // 底部前面两点
-        {innerSize, innerSize, -1.0f}, {-innerSize, innerSize, -1.0f},     // 底部后面两点
-        {-innerSize, -innerSize, 1.0f},  {innerSize, -innerSize, 1.0f},   // 顶部前面两点
-        {innerSize, innerSize, 1.0f},  {-innerSize, innerSize, 1.0f}      // 顶部后面两点
-    };
-    
-    // 定义内部长方体的12条边（用顶点索引对表示）
-    // 注意：我们只渲染通孔的内部边缘，以显示通孔效果
-    int innerCubeEdges[12][2] = {
-        {0, 1}, {1, 2}, {2, 3}, {3, 0},  // 底部四条边
-        {4, 5}, {5, 6}, {6, 7}, {7, 4},  // 顶部四条边
-        {0, 4}, {1, 5}, {2, 6}, {3, 7}   // 四条竖边
-    };
-    
-    // 为内部长方体的每条边创建线段对象并添加到渲染列表
-    for (int i = 0; i < 12; i++) {
-        LineSegment3D seg;
-        seg.start = innerCubeVertices[innerCubeEdges[i][0]];  // 设置边的起点
-        seg.end = innerCubeVertices[innerCubeEdges[i][1]];    // 设置边的终点
-        modelLines.push_back(seg);  // 添加到线段列表
-    }
+    // 命令行给出脚本文件时从脚本重放，否则使用内置的欧拉操作
+    string scriptPath = lpCmdLine ? lpCmdLine : "";
+    scriptPath.erase(0, scriptPath.find_first_not_of(" \t\""));
+    scriptPath.erase(scriptPath.find_last_not_of(" \t\"") + 1);
     
-    // 初始化图形窗口
+    // 着色模式的光栅化器先于窗口创建：窗口一出现就可能收到 WM_PAINT
+    SoftwareRasterizer shadedRasterizer;
+    rasterizer = &shadedRasterizer;
+
+    // 先初始化图形窗口，模型在后台构建，构建期间窗口显示包围盒和已构建的边
     HWND hwnd = initWindow(hInstance, "3D模型渲染器", 800, 600);
     if (!hwnd) {
-        delete model;  // 清理资源
         cerr << "无法创建窗口，程序退出" << endl;
         return 1;
     }
     
+    // 后台线程构建实体，再按面并行校验拓扑、三角化（着色模式使用）并生成线框
+    // 加载器在线程池之后声明，先于线程池析构：退出时先等后台线程结束，准备步骤仍可使用线程池
+    ThreadPool pool;
+    workerPool = &pool;
+    ModelLoader loader;
+    modelLoader = &loader;
+    loader.start([scriptPath](ModelLoader& self) { return buildModel(self, scriptPath); }, prepareModel,
+                 [hwnd] { PostMessage(hwnd, WM_MODEL_PROGRESS, 0, 0); });
+    
     // 输出操作说明到控制台
     cout << "渲染窗口已启动\n" << endl;
     cout << "操作说明:" << endl;
     cout << "- 左键拖动: 旋转模型" << endl;
     cout << "- 右键拖动: 平移模型" << endl;
     cout << "- 滚轮: 缩放模型" << endl;
+    cout << "- 按S键: 切换线框/平面着色/Gouraud着色" << endl;
+    cout << "- 按E键: 导出模型为 model.obj / model.stl / model.ply" << endl;
+    cout << "- 按M键: 输出模型和渲染缓冲的内存占用" << endl;
+    cout << "- 按F键: 线框模式下切换全部边/只画轮廓边和特征边" << endl;
     cout << "- 按ESC键: 退出程序" << endl;
     
     // Windows消息循环 - 处理所有窗口消息
@@ -549,8 +893,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         DispatchMessage(&msg);   // 分发消息到窗口过程
     }
     
-    // 程序结束前清理资源
-    delete model;
+    // 程序结束前清理资源：取消尚未完成的加载，未取走的实体由加载器释放
+    loader.cancel();
+    modelLoader = nullptr;
+    workerPool = nullptr;
+    rasterizer = nullptr;
+    delete currentModel;
+    currentModel = nullptr;
     
     cout << "\n程序执行完成。" << endl;
     return (int)msg.wParam;